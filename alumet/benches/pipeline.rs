@@ -0,0 +1,332 @@
+//! Benchmarks of the measurement pipeline hot paths.
+//!
+//! Run with `cargo bench -p alumet`.
+//! Criterion stores its baselines in `target/criterion`, use
+//! `cargo bench -p alumet -- --save-baseline <name>` and `--baseline <name>`
+//! to compare two versions of the code.
+
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{mpsc, Mutex};
+use std::time::{Duration, Instant};
+
+use criterion::{black_box, criterion_group, criterion_main, BatchSize, Criterion, Throughput};
+
+use alumet::agent::{static_plugins, AgentBuilder};
+use alumet::interning::intern;
+use alumet::measurement::{
+    MeasurementAccumulator, MeasurementBuffer, MeasurementPoint, Timestamp, WrappedMeasurementType,
+    WrappedMeasurementValue,
+};
+use alumet::metrics::{Metric, MetricRegistry, RawMetricId, TypedMetricId};
+use alumet::pipeline::builder::TransformChain;
+use alumet::pipeline::trigger::TriggerSpec;
+use alumet::pipeline::{Output, OutputContext, PollError, Source, Transform, TransformError, WriteError};
+use alumet::plugin::rust::AlumetPlugin;
+use alumet::plugin::{AlumetStart, ConfigTable};
+use alumet::resources::{Resource, ResourceConsumer};
+use alumet::units::Unit;
+
+/// Number of points pushed per iteration in the buffer and transform benchmarks.
+const N_POINTS: usize = 1000;
+
+/// Builds a registry with `n` u64 metrics named `metric_{i}`, and the typed id of the first one.
+fn test_registry(n: usize) -> (MetricRegistry, TypedMetricId<u64>) {
+    let metrics = (0..n)
+        .map(|i| Metric {
+            name: format!("metric_{i}"),
+            description: String::new(),
+            value_type: WrappedMeasurementType::U64,
+            unit: Unit::Second.into(),
+        })
+        .collect();
+    let registry = MetricRegistry::with_metrics(metrics).unwrap();
+    let metric = TypedMetricId::try_from(RawMetricId::from_u64(0), &registry).unwrap();
+    (registry, metric)
+}
+
+fn test_point(metric: TypedMetricId<u64>, value: u64) -> MeasurementPoint {
+    MeasurementPoint::new(
+        Timestamp::now(),
+        metric,
+        Resource::LocalMachine,
+        ResourceConsumer::LocalMachine,
+        value,
+    )
+}
+
+fn bench_buffer_push(c: &mut Criterion) {
+    let (_registry, metric) = test_registry(1);
+    let mut group = c.benchmark_group("MeasurementBuffer");
+    group.throughput(Throughput::Elements(N_POINTS as u64));
+
+    group.bench_function("push", |b| {
+        b.iter_batched(
+            || MeasurementBuffer::with_capacity(N_POINTS),
+            |mut buf| {
+                for i in 0..N_POINTS {
+                    buf.push(test_point(metric, i as u64));
+                }
+                buf
+            },
+            BatchSize::LargeInput,
+        )
+    });
+
+    group.bench_function("push_with_attrs", |b| {
+        b.iter_batched(
+            || MeasurementBuffer::with_capacity(N_POINTS),
+            |mut buf| {
+                for i in 0..N_POINTS {
+                    buf.push(
+                        test_point(metric, i as u64)
+                            .with_attr("domain", "benchmark")
+                            .with_attr("index", i as u64),
+                    );
+                }
+                buf
+            },
+            BatchSize::LargeInput,
+        )
+    });
+    group.finish();
+}
+
+fn bench_attributes(c: &mut Criterion) {
+    let (_registry, metric) = test_registry(1);
+    let interned = intern("benchmark-value");
+    let mut group = c.benchmark_group("with_attr");
+
+    group.bench_function("static_str", |b| {
+        b.iter(|| test_point(metric, 0).with_attr("kind", black_box("benchmark-value")))
+    });
+    // allocates a String per attribute, this is the costly variant
+    group.bench_function("owned_string", |b| {
+        b.iter(|| test_point(metric, 0).with_attr("kind", black_box("benchmark-value").to_string()))
+    });
+    // interned once, attaching is a copy
+    group.bench_function("interned", |b| {
+        b.iter(|| test_point(metric, 0).with_attr("kind", black_box(interned)))
+    });
+    group.finish();
+}
+
+fn bench_metric_registry(c: &mut Criterion) {
+    let (registry, _metric) = test_registry(100);
+    let id = RawMetricId::from_u64(64);
+    let mut group = c.benchmark_group("MetricRegistry");
+
+    group.bench_function("with_name", |b| {
+        b.iter(|| registry.with_name(black_box("metric_64")).unwrap())
+    });
+    group.bench_function("with_id", |b| b.iter(|| registry.with_id(black_box(&id)).unwrap()));
+    group.finish();
+}
+
+/// A transform that does nothing, to measure the cost of the dispatch itself.
+struct NoopTransform;
+impl Transform for NoopTransform {
+    fn apply(&mut self, _measurements: &mut MeasurementBuffer) -> Result<(), TransformError> {
+        Ok(())
+    }
+}
+
+/// A transform that reads every point, like a typical filtering/estimation transform.
+struct SumTransform;
+impl Transform for SumTransform {
+    fn apply(&mut self, measurements: &mut MeasurementBuffer) -> Result<(), TransformError> {
+        let mut sum = 0u64;
+        for m in measurements.iter() {
+            if let WrappedMeasurementValue::U64(v) = m.value {
+                sum = sum.wrapping_add(v);
+            }
+        }
+        black_box(sum);
+        Ok(())
+    }
+}
+
+/// A transform that modifies every point.
+struct ScaleTransform;
+impl Transform for ScaleTransform {
+    fn apply(&mut self, measurements: &mut MeasurementBuffer) -> Result<(), TransformError> {
+        for m in measurements.iter_mut() {
+            if let WrappedMeasurementValue::U64(v) = m.value {
+                m.value = WrappedMeasurementValue::U64(v.wrapping_mul(2));
+            }
+        }
+        Ok(())
+    }
+}
+
+fn bench_transform_chain(c: &mut Criterion) {
+    let (_registry, metric) = test_registry(1);
+    let mut buffer = MeasurementBuffer::with_capacity(N_POINTS);
+    for i in 0..N_POINTS {
+        buffer.push(test_point(metric, i as u64));
+    }
+    // The same dispatch as the transform step of the pipeline: a chain of boxed
+    // `dyn Transform` applied in order to the whole buffer.
+    let mut chain: Vec<Box<dyn Transform>> = vec![Box::new(NoopTransform), Box::new(SumTransform), Box::new(ScaleTransform)];
+
+    let mut group = c.benchmark_group("transforms");
+    group.throughput(Throughput::Elements(N_POINTS as u64));
+    group.bench_function("chain_of_3", |b| {
+        b.iter_batched(
+            || buffer.clone(),
+            |mut buf| {
+                for t in &mut chain {
+                    t.apply(&mut buf).unwrap();
+                }
+                buf
+            },
+            BatchSize::LargeInput,
+        )
+    });
+
+    // The same chain fused at compile time: one virtual call per buffer,
+    // statically dispatched (and inlinable) calls to the individual transforms.
+    let mut static_chain = TransformChain::new((NoopTransform, SumTransform, ScaleTransform));
+    group.bench_function("chain_of_3_static", |b| {
+        b.iter_batched(
+            || buffer.clone(),
+            |mut buf| {
+                static_chain.apply(&mut buf).unwrap();
+                buf
+            },
+            BatchSize::LargeInput,
+        )
+    });
+    group.finish();
+}
+
+// ====== End-to-end benchmark: synthetic source -> transform -> output ======
+
+/// Number of points produced by the synthetic source at each poll.
+const POINTS_PER_POLL: usize = 1000;
+/// Number of points that must reach the output for one end-to-end run.
+const END_TO_END_POINTS: u64 = 100_000;
+
+/// How many points the counting output has received so far.
+static RECEIVED: AtomicU64 = AtomicU64::new(0);
+/// How many points the counting output must receive before signalling `DONE_TX`.
+static TARGET: AtomicU64 = AtomicU64::new(0);
+/// Signalled by the counting output when `TARGET` is reached.
+static DONE_TX: Mutex<Option<mpsc::SyncSender<()>>> = Mutex::new(None);
+
+struct SyntheticSource {
+    metric: TypedMetricId<u64>,
+}
+impl Source for SyntheticSource {
+    fn poll(&mut self, measurements: &mut MeasurementAccumulator, timestamp: Timestamp) -> Result<(), PollError> {
+        for i in 0..POINTS_PER_POLL {
+            measurements.push(MeasurementPoint::new(
+                timestamp,
+                self.metric,
+                Resource::LocalMachine,
+                ResourceConsumer::LocalMachine,
+                i as u64,
+            ));
+        }
+        Ok(())
+    }
+}
+
+struct CountingOutput;
+impl Output for CountingOutput {
+    fn write(&mut self, measurements: &MeasurementBuffer, _ctx: &OutputContext) -> Result<(), WriteError> {
+        let received = RECEIVED.fetch_add(measurements.len() as u64, Ordering::Relaxed) + measurements.len() as u64;
+        if received >= TARGET.load(Ordering::Relaxed) {
+            if let Some(tx) = DONE_TX.lock().unwrap().take() {
+                let _ = tx.send(());
+            }
+        }
+        Ok(())
+    }
+}
+
+struct BenchPlugin;
+impl AlumetPlugin for BenchPlugin {
+    fn name() -> &'static str {
+        "pipeline-bench"
+    }
+
+    fn version() -> &'static str {
+        env!("CARGO_PKG_VERSION")
+    }
+
+    fn default_config() -> anyhow::Result<Option<ConfigTable>> {
+        Ok(None)
+    }
+
+    fn init(_config: ConfigTable) -> anyhow::Result<Box<Self>> {
+        Ok(Box::new(BenchPlugin))
+    }
+
+    fn start(&mut self, alumet: &mut AlumetStart) -> anyhow::Result<()> {
+        let metric = alumet.create_metric::<u64>("bench_points", Unit::Unity, "synthetic benchmark points")?;
+        alumet.add_source(
+            Box::new(SyntheticSource { metric }),
+            TriggerSpec::at_interval(Duration::from_micros(100)),
+        );
+        alumet.add_transform(Box::new(SumTransform));
+        alumet.add_output(Box::new(CountingOutput));
+        Ok(())
+    }
+
+    fn stop(&mut self) -> anyhow::Result<()> {
+        Ok(())
+    }
+}
+
+/// Runs a full pipeline (agent start included) until the output has received
+/// `n_points` points, and returns the time elapsed between the agent start and
+/// the moment the output reached the target.
+fn run_pipeline_once(n_points: u64) -> Duration {
+    RECEIVED.store(0, Ordering::Relaxed);
+    TARGET.store(n_points, Ordering::Relaxed);
+    let (tx, rx) = mpsc::sync_channel(1);
+    *DONE_TX.lock().unwrap() = Some(tx);
+
+    let mut global_config = toml::Table::new();
+    global_config.insert(String::from("plugins"), toml::Value::Table(toml::Table::new()));
+    let mut agent = AgentBuilder::new(static_plugins![BenchPlugin])
+        .config_value(global_config)
+        .build();
+    let config = agent.load_config().unwrap();
+
+    let start = Instant::now();
+    let mut running = agent.start(config).unwrap();
+    rx.recv().unwrap();
+    let elapsed = start.elapsed();
+
+    running.pipeline.control_handle().shutdown();
+    running.wait_for_shutdown().unwrap();
+    elapsed
+}
+
+fn bench_end_to_end(c: &mut Criterion) {
+    let mut group = c.benchmark_group("pipeline");
+    // each run starts a full agent, keep the number of samples low
+    group.sample_size(10);
+    group.throughput(Throughput::Elements(END_TO_END_POINTS));
+    group.bench_function("source_to_output", |b| {
+        b.iter_custom(|iters| {
+            let mut total = Duration::ZERO;
+            for _ in 0..iters {
+                total += run_pipeline_once(END_TO_END_POINTS);
+            }
+            total
+        })
+    });
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    bench_buffer_push,
+    bench_attributes,
+    bench_metric_registry,
+    bench_transform_chain,
+    bench_end_to_end
+);
+criterion_main!(benches);
@@ -142,6 +142,22 @@ typedef struct FfiMeasurementValue {
   };
 } FfiMeasurementValue;
 
+/**
+ * A measurement point in a C-compatible, by-value layout, without attributes.
+ *
+ * Unlike [`mpoint_new_u64`]/[`mpoint_new_f64`], an `FfiPoint` is not allocated by Alumet:
+ * the plugin fills an array of `FfiPoint`s and pushes them all at once with
+ * [`maccumulator_push_array`] or [`mbuffer_push_array`], which crosses the FFI
+ * boundary once per batch instead of twice per point.
+ */
+typedef struct FfiPoint {
+  struct Timestamp timestamp;
+  struct RawMetricId metric;
+  struct FfiMeasurementValue value;
+  struct FfiResourceId resource;
+  struct FfiConsumerId consumer;
+} FfiPoint;
+
 /**
  * FFI equivalent to [`String`].
  *
@@ -312,6 +328,36 @@ struct AString mpoint_consumer_kind(const struct MeasurementPoint *point);
 
 struct AString mpoint_consumer_id(const struct MeasurementPoint *point);
 
+/**
+ * Borrowed view of the resource kind, valid as long as the point is.
+ * This is the zero-allocation counterpart of [`mpoint_resource_kind`]; do **not** free the view.
+ */
+struct AStr mpoint_resource_kind_view(const struct MeasurementPoint *point);
+
+/**
+ * Borrowed view of the resource id, valid as long as the point is.
+ *
+ * Numeric ids (e.g. the id of a cpu package) are not stored as strings and cannot be
+ * borrowed: a null view is returned for them, and the caller should fall back to
+ * [`mpoint_resource_id`], which formats the id into an owned [`AString`].
+ */
+struct NullableAStr mpoint_resource_id_view(const struct MeasurementPoint *point);
+
+/**
+ * Borrowed view of the consumer kind, valid as long as the point is.
+ * This is the zero-allocation counterpart of [`mpoint_consumer_kind`]; do **not** free the view.
+ */
+struct AStr mpoint_consumer_kind_view(const struct MeasurementPoint *point);
+
+/**
+ * Borrowed view of the consumer id, valid as long as the point is.
+ *
+ * Numeric ids (e.g. the pid of a process) are not stored as strings and cannot be
+ * borrowed: a null view is returned for them, and the caller should fall back to
+ * [`mpoint_consumer_id`], which formats the id into an owned [`AString`].
+ */
+struct NullableAStr mpoint_consumer_id_view(const struct MeasurementPoint *point);
+
 uintptr_t mbuffer_len(const struct MeasurementBuffer *buf);
 
 void mbuffer_reserve(struct MeasurementBuffer *buf, uintptr_t additional);
@@ -333,6 +379,44 @@ void mbuffer_push(struct MeasurementBuffer *buf, struct MeasurementPoint *point)
  */
 void maccumulator_push(struct MeasurementAccumulator *buf, struct MeasurementPoint *point);
 
+/**
+ * Adds `count` measurements to the accumulator, read from a C array of [`FfiPoint`].
+ *
+ * This is the fast path for sources that produce many points per poll:
+ * one FFI call per batch, no per-point heap allocation.
+ * The points are consumed in the operation, you must **not** use them afterwards.
+ */
+void maccumulator_push_array(struct MeasurementAccumulator *buf,
+                             const struct FfiPoint *points,
+                             uintptr_t count);
+
+/**
+ * Adds `count` measurements to the buffer, read from a C array of [`FfiPoint`].
+ *
+ * See [`maccumulator_push_array`].
+ * The points are consumed in the operation, you must **not** use them afterwards.
+ */
+void mbuffer_push_array(struct MeasurementBuffer *buf,
+                        const struct FfiPoint *points,
+                        uintptr_t count);
+
+/**
+ * Copies up to `max_count` points of the buffer into a C array of [`FfiPoint`],
+ * and returns the number of points written.
+ *
+ * This is the read-side counterpart of [`mbuffer_push_array`]: an output plugin
+ * can read a whole buffer with one FFI call per batch (size the array with
+ * [`mbuffer_len`]) instead of one callback and several `mpoint_*` calls per point.
+ *
+ * The attributes of the points are not part of [`FfiPoint`]: use
+ * [`mbuffer_foreach`] and the `mpoint_*` accessors when they are needed.
+ * The resource and consumer ids are owned copies, like those returned by
+ * [`mpoint_resource`] and [`mpoint_consumer`].
+ */
+uintptr_t mbuffer_read_array(const struct MeasurementBuffer *buf,
+                             struct FfiPoint *out,
+                             uintptr_t max_count);
+
 struct RawMetricId alumet_create_metric(struct AlumetStart *alumet,
                                         struct AStr name,
                                         enum WrappedMeasurementType value_type,
@@ -2,6 +2,7 @@
 
 use std::{
     path::{Path, PathBuf},
+    sync::Mutex,
     time::Duration,
 };
 
@@ -9,7 +10,7 @@ use crate::{
     pipeline::{
         self,
         builder::PipelineBuilder,
-        runtime::{IdlePipeline, RunningPipeline},
+        runtime::{IdlePipeline, RunningPipeline, SourceOverloadPolicy},
         trigger::TriggerConstraints,
     },
     plugin::{AlumetStart, ConfigTable, Plugin, PluginMetadata},
@@ -77,7 +78,12 @@ pub struct AgentBuilder {
     f_before_operation_begin: fn(&IdlePipeline),
     f_after_operation_begin: fn(&mut RunningPipeline),
     allow_no_metrics: bool,
+    parallel_transforms: bool,
+    parallel_startup: bool,
     source_constraints: TriggerConstraints,
+    source_overload_policy: SourceOverloadPolicy,
+    priority_thread_affinity: Option<Vec<u32>>,
+    normal_thread_affinity: Option<Vec<u32>>,
 }
 
 enum AgentConfigSource {
@@ -180,17 +186,20 @@ impl Agent {
         log::info!("Initializing the plugins...");
 
         // initialize the plugins with the config
-        let mut initialized_plugins: Vec<Box<dyn Plugin>> = self
-            .settings
-            .plugins
-            .into_iter()
-            .map(|plugin| -> anyhow::Result<Box<dyn Plugin>> {
-                let name = plugin.name.clone();
-                let version = plugin.version.clone();
-                initialize_with_config(&mut config, plugin)
-                    .with_context(|| format!("Plugin failed to initialize: {} v{}", name, version))
-            })
-            .collect::<anyhow::Result<Vec<_>>>()?;
+        let mut initialized_plugins: Vec<Box<dyn Plugin>> = if self.settings.parallel_startup {
+            init_plugins_parallel(self.settings.plugins, &mut config)?
+        } else {
+            self.settings
+                .plugins
+                .into_iter()
+                .map(|plugin| -> anyhow::Result<Box<dyn Plugin>> {
+                    let name = plugin.name.clone();
+                    let version = plugin.version.clone();
+                    initialize_with_config(&mut config, plugin)
+                        .with_context(|| format!("Plugin failed to initialize: {} v{}", name, version))
+                })
+                .collect::<anyhow::Result<Vec<_>>>()?
+        };
 
         match initialized_plugins.len() {
             0 => log::warn!("No plugin has been initialized, please check your AgentBuilder."),
@@ -204,17 +213,31 @@ impl Agent {
         let mut pipeline_builder = pipeline::builder::PipelineBuilder::new();
         pipeline_builder.source_constraints = self.settings.source_constraints;
         pipeline_builder.allow_no_metrics = self.settings.allow_no_metrics;
-
-        for plugin in initialized_plugins.iter_mut() {
-            log::debug!("Starting plugin {} v{}", plugin.name(), plugin.version());
-            let mut start_struct = AlumetStart {
-                pipeline_builder: &mut pipeline_builder,
-                current_plugin_name: plugin.name().to_owned(),
-            };
-            plugin
-                .start(&mut start_struct)
-                .with_context(|| format!("Plugin failed to start: {} v{}", plugin.name(), plugin.version()))?;
+        pipeline_builder.parallel_transforms = self.settings.parallel_transforms;
+        pipeline_builder.source_overload_policy = self.settings.source_overload_policy;
+        pipeline_builder.priority_thread_affinity = self.settings.priority_thread_affinity.clone();
+        pipeline_builder.normal_thread_affinity = self.settings.normal_thread_affinity.clone();
+
+        // The builder is put behind a mutex so that the plugins can register their
+        // metrics and pipeline elements from multiple threads (see parallel_startup).
+        let pipeline_builder = Mutex::new(pipeline_builder);
+        if self.settings.parallel_startup {
+            start_plugins_parallel(&mut initialized_plugins, &pipeline_builder)?;
+        } else {
+            for plugin in initialized_plugins.iter_mut() {
+                log::debug!("Starting plugin {} v{}", plugin.name(), plugin.version());
+                let mut start_struct = AlumetStart {
+                    pipeline_builder: &pipeline_builder,
+                    current_plugin_name: plugin.name().to_owned(),
+                };
+                plugin
+                    .start(&mut start_struct)
+                    .with_context(|| format!("Plugin failed to start: {} v{}", plugin.name(), plugin.version()))?;
+            }
         }
+        let pipeline_builder = pipeline_builder
+            .into_inner()
+            .expect("pipeline builder mutex should not be poisoned");
         print_stats(&pipeline_builder, &initialized_plugins);
         (self.settings.f_after_plugin_start)(&pipeline_builder);
 
@@ -290,6 +313,20 @@ impl Agent {
     pub fn sources_max_update_interval(&mut self, max_update_interval: Duration) {
         self.settings.source_constraints.max_update_interval = max_update_interval;
     }
+
+    /// Pins the threads of the "realtime priority" runtime to the given cpu cores.
+    ///
+    /// See [`AgentBuilder::priority_thread_affinity`].
+    pub fn priority_thread_affinity(&mut self, cpus: Vec<u32>) {
+        self.settings.priority_thread_affinity = Some(cpus);
+    }
+
+    /// Pins the threads of the normal runtime to the given cpu cores.
+    ///
+    /// See [`AgentBuilder::normal_thread_affinity`].
+    pub fn normal_thread_affinity(&mut self, cpus: Vec<u32>) {
+        self.settings.normal_thread_affinity = Some(cpus);
+    }
 }
 
 impl RunningAgent {
@@ -389,6 +426,73 @@ fn initialize_with_config(agent_config: &mut AgentConfig, plugin: PluginMetadata
     (plugin.init)(ConfigTable(plugin_config))
 }
 
+/// Initializes the plugins concurrently, one thread per plugin.
+///
+/// The initialized plugins are returned in registration order, and on failure the
+/// first error (in that order) is reported, like in the sequential mode.
+fn init_plugins_parallel(
+    plugins: Vec<PluginMetadata>,
+    config: &mut AgentConfig,
+) -> anyhow::Result<Vec<Box<dyn Plugin>>> {
+    // Take each plugin's config out of the global config before spawning the threads.
+    let prepared: Vec<(PluginMetadata, toml::Table)> = plugins
+        .into_iter()
+        .map(|plugin| {
+            let plugin_config = config.take_plugin_config(&plugin.name)?;
+            Ok((plugin, plugin_config))
+        })
+        .collect::<anyhow::Result<Vec<_>>>()?;
+
+    std::thread::scope(|s| {
+        let handles: Vec<_> = prepared
+            .into_iter()
+            .map(|(plugin, plugin_config)| {
+                // Destructure the metadata: `default_config` is of no use here and stays on this thread.
+                let PluginMetadata {
+                    name, version, init, ..
+                } = plugin;
+                s.spawn(move || {
+                    log::debug!("Initializing plugin {name} with config {plugin_config:?}");
+                    init(ConfigTable(plugin_config))
+                        .with_context(|| format!("Plugin failed to initialize: {} v{}", name, version))
+                })
+            })
+            .collect();
+        handles
+            .into_iter()
+            .map(|handle| handle.join().expect("plugin init thread should not panic"))
+            .collect()
+    })
+}
+
+/// Starts the plugins concurrently, one thread per plugin.
+///
+/// Each plugin registers its metrics and pipeline elements through the shared,
+/// mutex-protected pipeline builder.
+fn start_plugins_parallel(
+    plugins: &mut [Box<dyn Plugin>],
+    pipeline_builder: &Mutex<PipelineBuilder>,
+) -> anyhow::Result<()> {
+    std::thread::scope(|s| {
+        let handles: Vec<_> = plugins
+            .iter_mut()
+            .map(|plugin| {
+                s.spawn(move || {
+                    log::debug!("Starting plugin {} v{}", plugin.name(), plugin.version());
+                    let mut start_struct = AlumetStart::new(pipeline_builder, plugin.name().to_owned());
+                    plugin
+                        .start(&mut start_struct)
+                        .with_context(|| format!("Plugin failed to start: {} v{}", plugin.name(), plugin.version()))
+                })
+            })
+            .collect();
+        handles
+            .into_iter()
+            .map(|handle| handle.join().expect("plugin start thread should not panic"))
+            .collect()
+    })
+}
+
 /// Prints some statistics after the plugin start-up phase.
 fn print_stats(pipeline_builder: &PipelineBuilder, plugins: &[Box<dyn Plugin>]) {
     // plugins
@@ -449,7 +553,12 @@ impl AgentBuilder {
             f_before_operation_begin: |_| (),
             f_after_operation_begin: |_| (),
             allow_no_metrics: false,
+            parallel_transforms: false,
+            parallel_startup: false,
             source_constraints: TriggerConstraints::default(),
+            source_overload_policy: SourceOverloadPolicy::default(),
+            priority_thread_affinity: None,
+            normal_thread_affinity: None,
         }
     }
 
@@ -528,6 +637,63 @@ impl AgentBuilder {
         self.allow_no_metrics = true;
         self
     }
+
+    /// Runs each transform in its own task, chained in registration order.
+    ///
+    /// Use this on machines with many cores when the transform stage
+    /// (several enabled transforms) becomes a single-core bottleneck.
+    /// The outputs still receive the measurements in flush order.
+    pub fn parallel_transforms(mut self) -> Self {
+        self.parallel_transforms = true;
+        self
+    }
+
+    /// Initializes and starts the plugins concurrently, one thread per plugin.
+    ///
+    /// Use this when some plugins take a long time to start (connecting to a database,
+    /// probing the hardware, walking `/sys`, ...): the duration of each startup phase
+    /// becomes roughly the maximum of the plugins' durations instead of their sum.
+    ///
+    /// The phases are preserved: every plugin is initialized before any plugin is
+    /// started, and the callbacks such as [`after_plugin_init`](Self::after_plugin_init)
+    /// run at the same points as in the sequential mode.
+    pub fn parallel_startup(mut self) -> Self {
+        self.parallel_startup = true;
+        self
+    }
+
+    /// Defines what the sources do when the pipeline cannot keep up with them
+    /// (e.g. an output waits for an unreachable database and the channel to the
+    /// transforms fills up).
+    ///
+    /// Whatever the policy, the sources keep polling on time: the policy only
+    /// controls which measurements get shed under pressure.
+    /// See [`SourceOverloadPolicy`] for the available policies and the default.
+    pub fn source_overload_policy(mut self, policy: SourceOverloadPolicy) -> Self {
+        self.source_overload_policy = policy;
+        self
+    }
+
+    /// Pins the threads of the "realtime priority" runtime to the given cpu cores.
+    ///
+    /// Without affinity, the scheduler migrates the realtime source threads freely,
+    /// and they can land on the same cores as the measured workloads, perturbing
+    /// both the polling cadence and the workloads. Pin them to a set of cores
+    /// isolated from the rest of the system (kernel parameter `isolcpus`, or a
+    /// dedicated cpuset) to get a flat polling latency profile.
+    pub fn priority_thread_affinity(mut self, cpus: Vec<u32>) -> Self {
+        self.priority_thread_affinity = Some(cpus);
+        self
+    }
+
+    /// Pins the threads of the normal runtime to the given cpu cores.
+    ///
+    /// Use this to keep the transforms, outputs and non-realtime sources away
+    /// from the cores reserved for the measured workloads.
+    pub fn normal_thread_affinity(mut self, cpus: Vec<u32>) -> Self {
+        self.normal_thread_affinity = Some(cpus);
+        self
+    }
 }
 
 /// Creates a [`Vec`] containing [`PluginMetadata`] for static plugins.
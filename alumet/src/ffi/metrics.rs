@@ -12,7 +12,7 @@ use crate::{
 
 use super::{
     resources::{FfiConsumerId, FfiResourceId},
-    string::{AStr, AString},
+    string::{AStr, AString, NullableAStr},
     time::Timestamp,
     FfiOutputContext,
 };
@@ -146,6 +146,50 @@ pub extern "C" fn mpoint_consumer_id(point: &MeasurementPoint) -> AString {
     point.consumer.id_display().to_string().into()
 }
 
+// Borrowed counterparts of the accessors above. Unlike an `AString`, the returned
+// views do not allocate and must not be freed: they borrow from the point, and are
+// only valid as long as the point is, i.e. for the duration of the current callback.
+
+/// Borrowed view of the resource kind, valid as long as the point is.
+/// This is the zero-allocation counterpart of [`mpoint_resource_kind`]; do **not** free the view.
+#[no_mangle]
+pub extern "C" fn mpoint_resource_kind_view(point: &MeasurementPoint) -> AStr<'_> {
+    point.resource.kind().into()
+}
+
+/// Borrowed view of the resource id, valid as long as the point is.
+///
+/// Numeric ids (e.g. the id of a cpu package) are not stored as strings and cannot be
+/// borrowed: a null view is returned for them, and the caller should fall back to
+/// [`mpoint_resource_id`], which formats the id into an owned [`AString`].
+#[no_mangle]
+pub extern "C" fn mpoint_resource_id_view(point: &MeasurementPoint) -> NullableAStr<'_> {
+    match point.resource.id_str() {
+        Some(id) => NullableAStr::from(id),
+        None => NullableAStr::null(),
+    }
+}
+
+/// Borrowed view of the consumer kind, valid as long as the point is.
+/// This is the zero-allocation counterpart of [`mpoint_consumer_kind`]; do **not** free the view.
+#[no_mangle]
+pub extern "C" fn mpoint_consumer_kind_view(point: &MeasurementPoint) -> AStr<'_> {
+    point.consumer.kind().into()
+}
+
+/// Borrowed view of the consumer id, valid as long as the point is.
+///
+/// Numeric ids (e.g. the pid of a process) are not stored as strings and cannot be
+/// borrowed: a null view is returned for them, and the caller should fall back to
+/// [`mpoint_consumer_id`], which formats the id into an owned [`AString`].
+#[no_mangle]
+pub extern "C" fn mpoint_consumer_id_view(point: &MeasurementPoint) -> NullableAStr<'_> {
+    match point.consumer.id_str() {
+        Some(id) => NullableAStr::from(id),
+        None => NullableAStr::null(),
+    }
+}
+
 #[repr(C)]
 pub enum FfiMeasurementValue {
     U64(u64),
@@ -159,6 +203,96 @@ impl From<&WrappedMeasurementValue> for FfiMeasurementValue {
         }
     }
 }
+impl From<FfiMeasurementValue> for WrappedMeasurementValue {
+    fn from(value: FfiMeasurementValue) -> Self {
+        match value {
+            FfiMeasurementValue::F64(x) => WrappedMeasurementValue::F64(x),
+            FfiMeasurementValue::U64(x) => WrappedMeasurementValue::U64(x),
+        }
+    }
+}
+
+// ====== Batched measurement push ======
+
+/// A measurement point in a C-compatible, by-value layout, without attributes.
+///
+/// Unlike [`mpoint_new_u64`]/[`mpoint_new_f64`], an `FfiPoint` is not allocated by Alumet:
+/// the plugin fills an array of `FfiPoint`s and pushes them all at once with
+/// [`maccumulator_push_array`] or [`mbuffer_push_array`], which crosses the FFI
+/// boundary once per batch instead of twice per point.
+#[repr(C)]
+pub struct FfiPoint {
+    pub timestamp: Timestamp,
+    pub metric: RawMetricId,
+    pub value: FfiMeasurementValue,
+    pub resource: FfiResourceId,
+    pub consumer: FfiConsumerId,
+}
+
+/// Internal: reads `count` points from a C array and pushes them to a [`MeasurementBuffer`].
+fn push_point_array(buf: &mut MeasurementBuffer, points: *const FfiPoint, count: usize) {
+    buf.reserve(count);
+    for i in 0..count {
+        // ptr::read moves the point out of the array: the resource and consumer ids
+        // are consumed, like in maccumulator_push. FfiPoint has no destructor on the
+        // C side, so the (now stale) array elements do not need any cleanup.
+        let p = unsafe { std::ptr::read(points.add(i)) };
+        buf.push(MeasurementPoint::new_untyped(
+            p.timestamp.into(),
+            p.metric,
+            Resource::from(p.resource),
+            ResourceConsumer::from(p.consumer),
+            WrappedMeasurementValue::from(p.value),
+        ));
+    }
+}
+
+/// Adds `count` measurements to the accumulator, read from a C array of [`FfiPoint`].
+///
+/// This is the fast path for sources that produce many points per poll:
+/// one FFI call per batch, no per-point heap allocation.
+/// The points are consumed in the operation, you must **not** use them afterwards.
+#[no_mangle]
+pub extern "C" fn maccumulator_push_array(buf: &mut MeasurementAccumulator, points: *const FfiPoint, count: usize) {
+    push_point_array(buf.buffer(), points, count);
+}
+
+/// Adds `count` measurements to the buffer, read from a C array of [`FfiPoint`].
+///
+/// See [`maccumulator_push_array`].
+/// The points are consumed in the operation, you must **not** use them afterwards.
+#[no_mangle]
+pub extern "C" fn mbuffer_push_array(buf: &mut MeasurementBuffer, points: *const FfiPoint, count: usize) {
+    push_point_array(buf, points, count);
+}
+
+/// Copies up to `max_count` points of the buffer into a C array of [`FfiPoint`],
+/// and returns the number of points written.
+///
+/// This is the read-side counterpart of [`mbuffer_push_array`]: an output plugin
+/// can read a whole buffer with one FFI call per batch (size the array with
+/// [`mbuffer_len`]) instead of one callback and several `mpoint_*` calls per point.
+///
+/// The attributes of the points are not part of [`FfiPoint`]: use
+/// [`mbuffer_foreach`] and the `mpoint_*` accessors when they are needed.
+/// The resource and consumer ids are owned copies, like those returned by
+/// [`mpoint_resource`] and [`mpoint_consumer`].
+#[no_mangle]
+pub extern "C" fn mbuffer_read_array(buf: &MeasurementBuffer, out: *mut FfiPoint, max_count: usize) -> usize {
+    let mut written = 0;
+    for point in buf.iter().take(max_count) {
+        let ffi_point = FfiPoint {
+            timestamp: point.timestamp.into(),
+            metric: point.metric,
+            value: (&point.value).into(),
+            resource: FfiResourceId::from(point.resource.to_owned()),
+            consumer: FfiConsumerId::from(point.consumer.to_owned()),
+        };
+        unsafe { std::ptr::write(out.add(written), ffi_point) };
+        written += 1;
+    }
+    written
+}
 
 // ====== MeasurementBuffer ffi ======
 #[no_mangle]
@@ -0,0 +1,119 @@
+//! Interning of strings, for cheap measurement attributes.
+//!
+//! Sources that attach the same string attributes to every point (for instance
+//! the name of a pod, or a fixed attribute key) would otherwise allocate a fresh
+//! heap `String` for every [`MeasurementPoint`](crate::measurement::MeasurementPoint),
+//! thousands of times per second. And every clone of the point, such as the broadcast
+//! of the measurements to the outputs, duplicates these allocations again.
+//!
+//! Interning replaces these allocations by a lookup in a process-wide table:
+//! [`intern`] returns a small [`InternedStr`] symbol, and attaching the symbol
+//! to a point only copies a `u32` (see
+//! [`MeasurementPoint::with_attr_interned`](crate::measurement::MeasurementPoint::with_attr_interned)).
+//!
+//! Interned strings are never freed: only intern strings that are repeated many times
+//! (attribute keys, pod names, ...), not unique values.
+//!
+//! ## Example
+//! ```
+//! use alumet::interning::intern;
+//!
+//! // intern once, typically when the source discovers the pod
+//! let pod_name = intern("my-pod-1234");
+//!
+//! // reuse the symbol for every measurement point, without allocating
+//! assert_eq!(pod_name.as_str(), "my-pod-1234");
+//! assert_eq!(intern("my-pod-1234"), pod_name);
+//! ```
+
+use std::collections::HashMap;
+use std::sync::{Mutex, OnceLock, RwLock};
+
+use fxhash::FxBuildHasher;
+
+/// A small symbol that represents an interned string.
+///
+/// Symbols are cheap to copy (a single `u32`) and cheap to compare:
+/// two symbols are equal if and only if the interned strings are equal.
+/// Use [`as_str`](Self::as_str) to get the string back.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct InternedStr(u32);
+
+/// The process-wide interning tables.
+///
+/// The deduplication map is only locked when interning, which happens rarely
+/// (when a source discovers a new attribute value). Resolving a symbol only
+/// takes a read lock on the append-only list of strings.
+struct Interner {
+    /// Maps each interned string to its symbol. Locked only by [`intern`].
+    indexes: Mutex<HashMap<&'static str, u32, FxBuildHasher>>,
+    /// The interned strings, indexed by symbol. Append-only.
+    strings: RwLock<Vec<&'static str>>,
+}
+
+fn global() -> &'static Interner {
+    static GLOBAL: OnceLock<Interner> = OnceLock::new();
+    GLOBAL.get_or_init(|| Interner {
+        indexes: Mutex::new(HashMap::default()),
+        strings: RwLock::new(Vec::new()),
+    })
+}
+
+/// Interns a string, returning its symbol.
+///
+/// If the string has already been interned, the existing symbol is returned.
+/// Otherwise, the string is copied into the process-wide interning table,
+/// where it stays for the lifetime of the process.
+pub fn intern(s: &str) -> InternedStr {
+    let interner = global();
+    let mut indexes = interner.indexes.lock().unwrap();
+    if let Some(i) = indexes.get(s) {
+        return InternedStr(*i);
+    }
+    // New string: leak a copy to make it 'static, it will live as long as the process anyway.
+    let leaked: &'static str = Box::leak(s.to_owned().into_boxed_str());
+    let mut strings = interner.strings.write().unwrap();
+    let i = u32::try_from(strings.len()).expect("too many interned strings");
+    strings.push(leaked);
+    indexes.insert(leaked, i);
+    InternedStr(i)
+}
+
+impl InternedStr {
+    /// Returns the interned string.
+    ///
+    /// The returned reference is `'static`: interned strings live as long as the process.
+    pub fn as_str(self) -> &'static str {
+        global().strings.read().unwrap()[self.0 as usize]
+    }
+}
+
+impl std::fmt::Display for InternedStr {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.write_str(self.as_str())
+    }
+}
+
+impl From<InternedStr> for &'static str {
+    fn from(value: InternedStr) -> Self {
+        value.as_str()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::intern;
+
+    #[test]
+    fn intern_dedup() {
+        let a = intern("alumet_test_intern_a");
+        let b = intern("alumet_test_intern_b");
+        let a2 = intern("alumet_test_intern_a");
+        assert_eq!(a, a2);
+        assert_ne!(a, b);
+        assert_eq!(a.as_str(), "alumet_test_intern_a");
+        assert_eq!(b.as_str(), "alumet_test_intern_b");
+        // the resolved strings are deduplicated too
+        assert_eq!(a.as_str().as_ptr(), a2.as_str().as_ptr());
+    }
+}
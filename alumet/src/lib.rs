@@ -12,6 +12,7 @@
 //! are provided by [plugins](plugin).
 
 pub mod agent;
+pub mod interning;
 pub mod measurement;
 pub mod metrics;
 pub mod pipeline;
@@ -29,8 +29,13 @@ use core::fmt;
 use std::borrow::Cow;
 use fxhash::FxBuildHasher;
 use smallvec::SmallVec;
+use std::sync::{Arc, Mutex};
 use std::{collections::HashMap, fmt::Display, time::SystemTime};
 
+#[cfg(target_os = "linux")]
+use std::time::Duration;
+
+use crate::interning::InternedStr;
 use crate::resources::ResourceConsumer;
 
 use super::metrics::{RawMetricId, TypedMetricId};
@@ -64,12 +69,17 @@ pub struct MeasurementPoint {
     pub consumer: ResourceConsumer,
 
     /// Additional attributes on the measurement point.
-    /// 
+    ///
     /// Not public because we could change how they are stored later (in fact it has already changed multiple times).
     /// Uses  [`SmallVec`] to avoid allocations if the number of attributes is small.
-    attributes: SmallVec<[(Cow<'static, str>, AttributeValue); 4]>
+    attributes: AttributeList,
 }
 
+/// List of attributes of a measurement point.
+///
+/// Uses [`SmallVec`] to avoid allocations if the number of attributes is small.
+type AttributeList = SmallVec<[(Cow<'static, str>, AttributeValue); 4]>;
+
 /// A measurement of a clock.
 ///
 /// This opaque type is currently a wrapper around [`SystemTime`],
@@ -140,6 +150,15 @@ impl MeasurementPoint {
         self
     }
 
+    /// Sets an attribute with an interned key on this measurement point.
+    ///
+    /// Unlike [`with_attr`](Self::with_attr) with a `String` key, this never allocates:
+    /// the key is resolved from the process-wide interning table (see [`crate::interning`]).
+    /// Use this for sources that attach the same keys and values to every point.
+    pub fn with_attr_interned<V: Into<AttributeValue>>(self, key: InternedStr, value: V) -> Self {
+        self.with_attr(key.as_str(), value)
+    }
+
     /// Attaches multiple attributes to this measurement point, from a [`Vec`].
     /// Existing attributes with conflicting keys are replaced.
     pub fn with_attr_vec<K: Into<Cow<'static, str>>>(mut self, attributes: Vec<(K, AttributeValue)>) -> Self {
@@ -165,6 +184,30 @@ impl Timestamp {
     pub fn now() -> Self {
         Self(SystemTime::now())
     }
+
+    /// Returns a `Timestamp` from a coarse, cached clock.
+    ///
+    /// On Linux, this reads `CLOCK_REALTIME_COARSE`: a snapshot of the system time
+    /// that the kernel refreshes on each scheduler tick and that is served from the
+    /// vDSO without a system call. It is several times cheaper than [`now`](Self::now),
+    /// and all the reads performed within the same tick observe the same value,
+    /// so the timestamps of a poll burst are aligned (which helps downstream batching
+    /// and compression). The trade-off is the granularity: the kernel tick, usually
+    /// 1 to 4 ms.
+    ///
+    /// On other platforms, this falls back to [`now`](Self::now).
+    pub fn now_coarse() -> Self {
+        #[cfg(target_os = "linux")]
+        {
+            let mut ts = libc::timespec { tv_sec: 0, tv_nsec: 0 };
+            // SAFETY: ts is a valid timespec, and CLOCK_REALTIME_COARSE is always available on Linux >= 2.6.32.
+            if unsafe { libc::clock_gettime(libc::CLOCK_REALTIME_COARSE, &mut ts) } == 0 {
+                return Self(SystemTime::UNIX_EPOCH + Duration::new(ts.tv_sec as u64, ts.tv_nsec as u32));
+            }
+            // on failure (which should not happen), fall back to the precise clock
+        }
+        Self::now()
+    }
 }
 
 impl From<SystemTime> for Timestamp {
@@ -229,7 +272,7 @@ impl fmt::Display for WrappedMeasurementType {
 }
 
 /// A measurement value of any supported measurement type.
-#[derive(Debug, Clone)]
+#[derive(Debug, Clone, PartialEq)]
 pub enum WrappedMeasurementValue {
     F64(f64),
     U64(u64),
@@ -258,6 +301,24 @@ pub enum AttributeValue {
     String(String),
 }
 
+impl PartialEq for AttributeValue {
+    /// Compares two attribute values.
+    /// String attributes are equal if their contents are equal,
+    /// regardless of how they are stored ([`Str`](Self::Str) or [`String`](Self::String)).
+    fn eq(&self, other: &Self) -> bool {
+        match (self, other) {
+            (AttributeValue::F64(a), AttributeValue::F64(b)) => a == b,
+            (AttributeValue::U64(a), AttributeValue::U64(b)) => a == b,
+            (AttributeValue::Bool(a), AttributeValue::Bool(b)) => a == b,
+            (AttributeValue::Str(a), AttributeValue::Str(b)) => a == b,
+            (AttributeValue::Str(a), AttributeValue::String(b)) => *a == b.as_str(),
+            (AttributeValue::String(a), AttributeValue::Str(b)) => a.as_str() == *b,
+            (AttributeValue::String(a), AttributeValue::String(b)) => a == b,
+            _ => false,
+        }
+    }
+}
+
 impl Display for AttributeValue {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         match self {
@@ -300,23 +361,38 @@ impl From<&'static str> for AttributeValue {
     }
 }
 
+impl From<InternedStr> for AttributeValue {
+    fn from(value: InternedStr) -> Self {
+        // Interned strings are 'static, so the borrowed variant applies: no allocation,
+        // and cloning the attribute (e.g. in the broadcast to outputs) is a pointer copy.
+        AttributeValue::Str(value.as_str())
+    }
+}
+
 /// A `MeasurementBuffer` stores measured data points.
 /// Unlike a [`MeasurementAccumulator`], the buffer allows to modify the measurements.
 #[derive(Clone)]
 pub struct MeasurementBuffer {
     points: Vec<MeasurementPoint>,
+    /// The pool that this buffer was checked out of, if any.
+    /// On drop, the allocation of `points` goes back to the pool instead of the allocator.
+    pool: Option<BufferPool>,
 }
 
 impl MeasurementBuffer {
     /// Constructs a new buffer.
     pub fn new() -> MeasurementBuffer {
-        MeasurementBuffer { points: Vec::new() }
+        MeasurementBuffer {
+            points: Vec::new(),
+            pool: None,
+        }
     }
 
     /// Constructs a new buffer with at least the specified capacity (allocated on construction).
     pub fn with_capacity(capacity: usize) -> MeasurementBuffer {
         MeasurementBuffer {
             points: Vec::with_capacity(capacity),
+            pool: None,
         }
     }
     
@@ -347,6 +423,15 @@ impl MeasurementBuffer {
         self.points.clear();
     }
 
+    /// Keeps only the `n` most recently pushed measurements, removing the oldest ones.
+    ///
+    /// Does nothing if the buffer contains `n` measurements or less.
+    pub fn retain_latest(&mut self, n: usize) {
+        if self.points.len() > n {
+            self.points.drain(..self.points.len() - n);
+        }
+    }
+
     /// Creates an iterator on the buffer's content.
     pub fn iter(&self) -> impl Iterator<Item = &MeasurementPoint> {
         self.points.iter()
@@ -363,6 +448,14 @@ impl MeasurementBuffer {
     }
 }
 
+impl Drop for MeasurementBuffer {
+    fn drop(&mut self) {
+        if let Some(pool) = self.pool.take() {
+            pool.recycle(std::mem::take(&mut self.points));
+        }
+    }
+}
+
 impl<'a> IntoIterator for &'a MeasurementBuffer {
     type Item = &'a MeasurementPoint;
     type IntoIter = std::slice::Iter<'a, MeasurementPoint>;
@@ -382,7 +475,79 @@ impl std::fmt::Debug for MeasurementBuffer {
 
 impl From<Vec<MeasurementPoint>> for MeasurementBuffer {
     fn from(value: Vec<MeasurementPoint>) -> Self {
-        MeasurementBuffer { points: value }
+        MeasurementBuffer {
+            points: value,
+            pool: None,
+        }
+    }
+}
+
+/// Maximum number of spare allocations kept by a [`BufferPool`].
+///
+/// The downstream of a source holds a bounded number of buffers at any given time
+/// (one in flight per channel slot), so a small cap is enough to reach steady state.
+const MAX_SPARE_BUFFERS: usize = 8;
+
+/// A pool of [`MeasurementBuffer`]s that recycles their allocations.
+///
+/// At high polling frequencies, allocating a fresh buffer on every flush and dropping
+/// it after the outputs are done churns the allocator. A pool avoids this: buffers
+/// are [checked out](Self::get) by the source task, and when the last owner drops the
+/// buffer (usually an output, after the broadcast), its allocation automatically goes
+/// back to the pool and is reused by a later flush cycle. In steady state, the buffer
+/// plumbing performs no heap allocation.
+///
+/// The pool is cheap to clone (it is a shared handle) and keeps at most a few spare
+/// allocations; extra ones are simply freed.
+#[derive(Clone)]
+pub struct BufferPool {
+    spares: Arc<Mutex<Vec<Vec<MeasurementPoint>>>>,
+}
+
+impl BufferPool {
+    /// Creates a new, empty pool.
+    pub fn new() -> Self {
+        Self {
+            spares: Arc::new(Mutex::new(Vec::new())),
+        }
+    }
+
+    /// Checks a buffer out of the pool, reusing a spare allocation if one is available.
+    ///
+    /// The buffer is empty and has a capacity of at least `capacity`.
+    /// When the buffer (and all its clones) are dropped, the allocation returns to the pool.
+    pub fn get(&self, capacity: usize) -> MeasurementBuffer {
+        let mut points = self.spares.lock().unwrap().pop().unwrap_or_default();
+        if points.capacity() < capacity {
+            points.reserve(capacity - points.len());
+        }
+        MeasurementBuffer {
+            points,
+            pool: Some(self.clone()),
+        }
+    }
+
+    /// The number of spare allocations currently held by the pool.
+    pub fn spare_count(&self) -> usize {
+        self.spares.lock().unwrap().len()
+    }
+
+    /// Puts an allocation back into the pool (called when a pooled buffer is dropped).
+    fn recycle(&self, mut points: Vec<MeasurementPoint>) {
+        if points.capacity() == 0 {
+            return; // nothing worth keeping
+        }
+        points.clear();
+        let mut spares = self.spares.lock().unwrap();
+        if spares.len() < MAX_SPARE_BUFFERS {
+            spares.push(points);
+        }
+    }
+}
+
+impl Default for BufferPool {
+    fn default() -> Self {
+        Self::new()
     }
 }
 
@@ -396,4 +561,377 @@ impl<'a> MeasurementAccumulator<'a> {
     pub fn push(&mut self, point: MeasurementPoint) {
         self.0.push(point)
     }
+
+    /// The underlying buffer, for internal uses that need more than pushing
+    /// (such as the batched FFI push).
+    pub(crate) fn buffer(&mut self) -> &mut MeasurementBuffer {
+        self.0
+    }
+}
+
+/// Sentinel for "this point has no attributes" in [`ColumnarMeasurementBuffer`].
+const NO_ATTRIBUTES: u32 = u32::MAX;
+
+/// A measurement buffer with a columnar (struct-of-arrays) memory layout.
+///
+/// Unlike [`MeasurementBuffer`], which stores a `Vec` of "fat" [`MeasurementPoint`]s,
+/// the columnar buffer stores each field of the points in its own dense array:
+/// timestamps together, metric ids together, values together.
+/// The (resource, consumer) pairs, which are typically repeated many times
+/// (a source usually produces thousands of points about a handful of resources),
+/// are deduplicated into a side table and each point only stores a `u32` index.
+///
+/// This layout is more cache-friendly for pipeline elements that only look at
+/// a subset of the fields. In particular, a transform that only modifies the
+/// measured values can iterate on [`values_mut`](Self::values_mut), a dense
+/// array of [`WrappedMeasurementValue`], without striding over the resources,
+/// consumers and attributes of the points.
+///
+/// ## Conversions
+///
+/// A columnar buffer can be built from and turned into a [`MeasurementBuffer`]:
+/// ```
+/// use alumet::measurement::{ColumnarMeasurementBuffer, MeasurementBuffer};
+///
+/// let buffer = MeasurementBuffer::new();
+/// let columnar = ColumnarMeasurementBuffer::from(&buffer);
+/// let back: MeasurementBuffer = (&columnar).into();
+/// ```
+pub struct ColumnarMeasurementBuffer {
+    /// Timestamp of each point.
+    timestamps: Vec<Timestamp>,
+    /// Metric of each point.
+    metrics: Vec<RawMetricId>,
+    /// Value of each point.
+    values: Vec<WrappedMeasurementValue>,
+    /// For each point, the index of its (resource, consumer) pair in `pairs`.
+    point_pairs: Vec<u32>,
+    /// For each point, the index of its attributes in `attributes`, or [`NO_ATTRIBUTES`].
+    point_attributes: Vec<u32>,
+
+    /// Deduplicated (resource, consumer) pairs.
+    pairs: Vec<(Resource, ResourceConsumer)>,
+    /// Maps each known (resource, consumer) pair to its index in `pairs`.
+    pair_indexes: HashMap<(Resource, ResourceConsumer), u32, FxBuildHasher>,
+    /// Attribute lists of the points that have attributes (most points have none).
+    attributes: Vec<AttributeList>,
+}
+
+impl ColumnarMeasurementBuffer {
+    /// Constructs a new columnar buffer.
+    pub fn new() -> Self {
+        Self {
+            timestamps: Vec::new(),
+            metrics: Vec::new(),
+            values: Vec::new(),
+            point_pairs: Vec::new(),
+            point_attributes: Vec::new(),
+            pairs: Vec::new(),
+            pair_indexes: HashMap::default(),
+            attributes: Vec::new(),
+        }
+    }
+
+    /// Constructs a new columnar buffer with at least the specified capacity
+    /// (for the per-point columns, not the deduplicated side tables).
+    pub fn with_capacity(capacity: usize) -> Self {
+        Self {
+            timestamps: Vec::with_capacity(capacity),
+            metrics: Vec::with_capacity(capacity),
+            values: Vec::with_capacity(capacity),
+            point_pairs: Vec::with_capacity(capacity),
+            point_attributes: Vec::with_capacity(capacity),
+            pairs: Vec::new(),
+            pair_indexes: HashMap::default(),
+            attributes: Vec::new(),
+        }
+    }
+
+    /// Returns true if this buffer is empty.
+    pub fn is_empty(&self) -> bool {
+        self.timestamps.is_empty()
+    }
+
+    /// Returns the number of measurement points in the buffer.
+    pub fn len(&self) -> usize {
+        self.timestamps.len()
+    }
+
+    /// Returns the number of distinct (resource, consumer) pairs in the buffer.
+    pub fn pairs_len(&self) -> usize {
+        self.pairs.len()
+    }
+
+    /// Clears the buffer, removing all the points and the deduplicated side tables.
+    pub fn clear(&mut self) {
+        self.timestamps.clear();
+        self.metrics.clear();
+        self.values.clear();
+        self.point_pairs.clear();
+        self.point_attributes.clear();
+        self.pairs.clear();
+        self.pair_indexes.clear();
+        self.attributes.clear();
+    }
+
+    /// Adds a measurement to the buffer.
+    ///
+    /// The point is decomposed into the buffer's columns, and its (resource, consumer)
+    /// pair is deduplicated against the pairs that are already in the buffer.
+    pub fn push(&mut self, point: MeasurementPoint) {
+        let pair = (point.resource, point.consumer);
+        let pair_index = match self.pair_indexes.get(&pair) {
+            Some(i) => *i,
+            None => {
+                let i = u32::try_from(self.pairs.len()).expect("too many distinct (resource, consumer) pairs");
+                self.pairs.push(pair.clone());
+                self.pair_indexes.insert(pair, i);
+                i
+            }
+        };
+        let attr_index = if point.attributes.is_empty() {
+            NO_ATTRIBUTES
+        } else {
+            let i = u32::try_from(self.attributes.len()).expect("too many points with attributes");
+            self.attributes.push(point.attributes);
+            i
+        };
+        self.timestamps.push(point.timestamp);
+        self.metrics.push(point.metric);
+        self.values.push(point.value);
+        self.point_pairs.push(pair_index);
+        self.point_attributes.push(attr_index);
+    }
+
+    /// The timestamp column: one [`Timestamp`] per point.
+    pub fn timestamps(&self) -> &[Timestamp] {
+        &self.timestamps
+    }
+
+    /// The metric column: one [`RawMetricId`] per point.
+    pub fn metrics(&self) -> &[RawMetricId] {
+        &self.metrics
+    }
+
+    /// The value column: one [`WrappedMeasurementValue`] per point.
+    pub fn values(&self) -> &[WrappedMeasurementValue] {
+        &self.values
+    }
+
+    /// The value column, mutable.
+    ///
+    /// This is the fast path for transforms that only modify the measured values:
+    /// the values are contiguous in memory, no other field of the points is touched.
+    pub fn values_mut(&mut self) -> &mut [WrappedMeasurementValue] {
+        &mut self.values
+    }
+
+    /// Creates an iterator on the points of the buffer, as cheap [`ColumnarPointRef`] views.
+    pub fn iter(&self) -> impl Iterator<Item = ColumnarPointRef<'_>> {
+        (0..self.len()).map(|i| ColumnarPointRef { buffer: self, index: i })
+    }
+}
+
+impl Default for ColumnarMeasurementBuffer {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl std::fmt::Debug for ColumnarMeasurementBuffer {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("ColumnarMeasurementBuffer")
+            .field("len", &self.len())
+            .field("pairs_len", &self.pairs_len())
+            .finish()
+    }
+}
+
+impl From<&MeasurementBuffer> for ColumnarMeasurementBuffer {
+    fn from(buffer: &MeasurementBuffer) -> Self {
+        let mut res = ColumnarMeasurementBuffer::with_capacity(buffer.len());
+        for point in buffer.iter() {
+            res.push(point.clone());
+        }
+        res
+    }
+}
+
+impl From<MeasurementBuffer> for ColumnarMeasurementBuffer {
+    fn from(mut buffer: MeasurementBuffer) -> Self {
+        let mut res = ColumnarMeasurementBuffer::with_capacity(buffer.len());
+        // take the points out (the buffer has a Drop impl, its field cannot be moved out directly)
+        for point in std::mem::take(&mut buffer.points) {
+            res.push(point);
+        }
+        res
+    }
+}
+
+impl From<&ColumnarMeasurementBuffer> for MeasurementBuffer {
+    fn from(buffer: &ColumnarMeasurementBuffer) -> Self {
+        let mut res = MeasurementBuffer::with_capacity(buffer.len());
+        for point in buffer.iter() {
+            res.push(point.to_point());
+        }
+        res
+    }
+}
+
+/// A cheap view of one point of a [`ColumnarMeasurementBuffer`].
+///
+/// Unlike [`MeasurementPoint`], the view does not own its resource, consumer and attributes:
+/// it borrows them from the buffer's deduplicated side tables.
+#[derive(Clone, Copy)]
+pub struct ColumnarPointRef<'a> {
+    buffer: &'a ColumnarMeasurementBuffer,
+    index: usize,
+}
+
+impl<'a> ColumnarPointRef<'a> {
+    /// The metric of this point.
+    pub fn metric(&self) -> RawMetricId {
+        self.buffer.metrics[self.index]
+    }
+
+    /// The timestamp of this point.
+    pub fn timestamp(&self) -> Timestamp {
+        self.buffer.timestamps[self.index]
+    }
+
+    /// The value of this point.
+    pub fn value(&self) -> &'a WrappedMeasurementValue {
+        &self.buffer.values[self.index]
+    }
+
+    /// The resource that this point is about.
+    pub fn resource(&self) -> &'a Resource {
+        &self.buffer.pairs[self.buffer.point_pairs[self.index] as usize].0
+    }
+
+    /// The consumer of the resource.
+    pub fn consumer(&self) -> &'a ResourceConsumer {
+        &self.buffer.pairs[self.buffer.point_pairs[self.index] as usize].1
+    }
+
+    /// Iterates on the attributes attached to this point.
+    pub fn attributes(&self) -> impl Iterator<Item = (&'a str, &'a AttributeValue)> {
+        let attrs = match self.buffer.point_attributes[self.index] {
+            NO_ATTRIBUTES => &[],
+            i => self.buffer.attributes[i as usize].as_slice(),
+        };
+        attrs.iter().map(|(k, v)| (k.as_ref(), v))
+    }
+
+    /// Copies this view into an owned [`MeasurementPoint`].
+    pub fn to_point(&self) -> MeasurementPoint {
+        MeasurementPoint {
+            metric: self.metric(),
+            timestamp: self.timestamp(),
+            value: self.value().clone(),
+            resource: self.resource().clone(),
+            consumer: self.consumer().clone(),
+            attributes: match self.buffer.point_attributes[self.index] {
+                NO_ATTRIBUTES => SmallVec::new(),
+                i => self.buffer.attributes[i as usize].clone(),
+            },
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::{ColumnarMeasurementBuffer, MeasurementBuffer, MeasurementPoint, Timestamp, WrappedMeasurementValue};
+    use crate::metrics::RawMetricId;
+    use crate::resources::{Resource, ResourceConsumer};
+
+    fn test_point(metric: usize, value: u64, cpu: u32) -> MeasurementPoint {
+        MeasurementPoint::new_untyped(
+            Timestamp::now(),
+            RawMetricId(metric),
+            Resource::CpuPackage { id: cpu },
+            ResourceConsumer::LocalMachine,
+            WrappedMeasurementValue::U64(value),
+        )
+    }
+
+    #[test]
+    fn columnar_push_dedup() {
+        let mut buf = ColumnarMeasurementBuffer::new();
+        assert!(buf.is_empty());
+        for i in 0..100 {
+            // only 2 distinct (resource, consumer) pairs
+            buf.push(test_point(0, i, (i % 2) as u32));
+        }
+        assert_eq!(buf.len(), 100);
+        assert_eq!(buf.pairs_len(), 2);
+        assert_eq!(buf.values().len(), 100);
+
+        // dense modification of the values
+        for v in buf.values_mut() {
+            if let WrappedMeasurementValue::U64(x) = v {
+                *x += 1;
+            }
+        }
+        let first = buf.iter().next().unwrap();
+        assert!(matches!(first.value(), WrappedMeasurementValue::U64(1)));
+        assert_eq!(*first.resource(), Resource::CpuPackage { id: 0 });
+
+        buf.clear();
+        assert!(buf.is_empty());
+        assert_eq!(buf.pairs_len(), 0);
+    }
+
+    #[test]
+    fn coarse_timestamp() {
+        use std::time::{Duration, SystemTime};
+        let coarse: SystemTime = Timestamp::now_coarse().into();
+        let precise: SystemTime = Timestamp::now().into();
+        // the coarse clock lags behind the precise one by at most a few kernel ticks
+        let lag = precise.duration_since(coarse).unwrap_or_default();
+        assert!(lag < Duration::from_secs(1), "coarse clock lags too much: {lag:?}");
+    }
+
+    #[test]
+    fn buffer_pool_recycling() {
+        let pool = super::BufferPool::new();
+        assert_eq!(pool.spare_count(), 0);
+
+        let mut buf = pool.get(16);
+        for i in 0..10 {
+            buf.push(test_point(0, i, 0));
+        }
+        drop(buf);
+        assert_eq!(pool.spare_count(), 1, "dropping a pooled buffer must recycle it");
+
+        let mut buf = pool.get(4);
+        assert_eq!(pool.spare_count(), 0, "the spare allocation must be reused");
+        assert!(buf.is_empty(), "recycled buffers must be empty");
+
+        // clones of a pooled buffer return their own allocation to the pool
+        buf.push(test_point(0, 0, 0));
+        let clone = buf.clone();
+        drop(buf);
+        drop(clone);
+        assert_eq!(pool.spare_count(), 2);
+    }
+
+    #[test]
+    fn columnar_conversions() {
+        let mut row_buf = MeasurementBuffer::new();
+        row_buf.push(test_point(0, 1, 0).with_attr("k", "v"));
+        row_buf.push(test_point(1, 2, 0));
+
+        let columnar = ColumnarMeasurementBuffer::from(&row_buf);
+        assert_eq!(columnar.len(), 2);
+        assert_eq!(columnar.pairs_len(), 1);
+        let attrs: Vec<_> = columnar.iter().next().unwrap().attributes().collect();
+        assert_eq!(attrs.len(), 1);
+        assert_eq!(attrs[0].0, "k");
+
+        let back = MeasurementBuffer::from(&columnar);
+        assert_eq!(back.len(), 2);
+        let first = back.iter().next().unwrap();
+        assert_eq!(first.attributes_len(), 1);
+    }
 }
@@ -84,7 +84,9 @@ pub trait MetricId {
 /// New metrics are created by the plugins during their initialization.
 #[derive(Clone)]
 pub struct MetricRegistry {
-    pub(crate) metrics_by_id: HashMap<RawMetricId, Metric>,
+    /// The metrics, indexed by their id: ids are small sequential integers,
+    /// so a dense Vec turns `with_id` (called per point by the outputs) into an array access.
+    pub(crate) metrics_by_id: Vec<Metric>,
     pub(crate) metrics_by_name: HashMap<String, RawMetricId>,
 }
 
@@ -168,19 +170,33 @@ impl MetricRegistry {
     /// Creates a new registry, but does not make it "global" yet.
     pub(crate) fn new() -> MetricRegistry {
         MetricRegistry {
-            metrics_by_id: HashMap::new(),
+            metrics_by_id: Vec::new(),
             metrics_by_name: HashMap::new(),
         }
     }
 
+    /// Creates a registry that contains the given metrics, with sequential ids starting at 0.
+    ///
+    /// In an agent, the registry is populated during the plugin startup phase
+    /// (see [`AlumetStart::create_metric`](crate::plugin::AlumetStart::create_metric)).
+    /// This constructor is intended for tests and benchmarks that exercise
+    /// pipeline components outside of a full agent.
+    pub fn with_metrics(metrics: Vec<Metric>) -> Result<MetricRegistry, MetricCreationError> {
+        let mut registry = MetricRegistry::new();
+        for m in metrics {
+            registry.register(m)?;
+        }
+        Ok(registry)
+    }
+
     /// Finds the metric that has the given id.
     pub fn with_id<M: MetricId>(&self, id: &M) -> Option<&Metric> {
-        self.metrics_by_id.get(&id.untyped_id())
+        self.metrics_by_id.get(id.untyped_id().0)
     }
 
     /// Finds the metric that has the given name.
     pub fn with_name(&self, name: &str) -> Option<&Metric> {
-        self.metrics_by_name.get(name).and_then(|id| self.metrics_by_id.get(id))
+        self.metrics_by_name.get(name).and_then(|id| self.metrics_by_id.get(id.0))
     }
 
     /// The number of metrics in the registry.
@@ -196,7 +212,7 @@ impl MetricRegistry {
     pub fn iter(&self) -> MetricIter<'_> {
         // return new iterator
         MetricIter {
-            entries: self.metrics_by_id.iter(),
+            entries: self.metrics_by_id.iter().enumerate(),
         }
     }
 
@@ -210,9 +226,9 @@ impl MetricRegistry {
                 "A metric with this name already exist: {name}"
             )));
         }
-        let id = RawMetricId(self.metrics_by_name.len());
+        let id = RawMetricId(self.metrics_by_id.len());
         self.metrics_by_name.insert(name.clone(), id);
-        self.metrics_by_id.insert(id, m);
+        self.metrics_by_id.push(m);
         Ok(id)
     }
 
@@ -239,35 +255,33 @@ impl MetricRegistry {
     pub(crate) fn extend_infallible(&mut self, metrics: Vec<Metric>, dedup_suffix: &str) -> Vec<RawMetricId> {
         self.metrics_by_name.reserve(metrics.len());
         self.metrics_by_id.reserve(metrics.len());
-        let base_id = self.len();
         metrics
             .into_iter()
-            .enumerate()
-            .map(|(i, mut metric)| {
+            .map(|mut metric| {
                 metric.name = self.deduplicated_name(&metric.name, dedup_suffix);
-                let id = RawMetricId(base_id + i);
+                let id = RawMetricId(self.metrics_by_id.len());
                 self.metrics_by_name.insert(metric.name.clone(), id);
-                self.metrics_by_id.insert(id, metric);
+                self.metrics_by_id.push(metric);
                 id
             })
             .collect()
     }
 }
 
-/// An iterator over the metrics of a [`MetricRegistry`].
+/// An iterator over the metrics of a [`MetricRegistry`], in id order.
 pub struct MetricIter<'a> {
-    entries: std::collections::hash_map::Iter<'a, RawMetricId, Metric>,
+    entries: std::iter::Enumerate<std::slice::Iter<'a, Metric>>,
 }
 impl<'a> Iterator for MetricIter<'a> {
-    type Item = (&'a RawMetricId, &'a Metric);
+    type Item = (RawMetricId, &'a Metric);
 
     fn next(&mut self) -> Option<Self::Item> {
-        self.entries.next()
+        self.entries.next().map(|(id, metric)| (RawMetricId(id), metric))
     }
 }
 
 impl<'a> IntoIterator for &'a MetricRegistry {
-    type Item = (&'a RawMetricId, &'a Metric);
+    type Item = (RawMetricId, &'a Metric);
 
     type IntoIter = MetricIter<'a>;
 
@@ -0,0 +1,310 @@
+//! Built-in windowed aggregation of measurements.
+//!
+//! Sources are often polled at a high frequency for accuracy (e.g. reading energy
+//! counters every millisecond to avoid missing an overflow), but the full resolution
+//! rarely needs to reach the outputs. The [`WindowedAggregation`] transform folds all
+//! the points of a time window into a single point per (metric, resource, consumer),
+//! so that 1000 points/s/metric become 1 point/s before the broadcast to the outputs,
+//! cutting the load of the outputs and of whatever lies behind them (relay, database).
+
+use std::collections::HashMap;
+use std::time::{Duration, SystemTime};
+
+use fxhash::FxBuildHasher;
+
+use crate::measurement::{MeasurementBuffer, MeasurementPoint, Timestamp, WrappedMeasurementValue};
+use crate::metrics::RawMetricId;
+use crate::resources::{Resource, ResourceConsumer};
+
+use super::{Transform, TransformError};
+
+/// How the values of a window are folded into a single value.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum AggregationFunction {
+    /// The sum of the values.
+    Sum,
+    /// The arithmetic mean of the values (integer division for u64 metrics).
+    Mean,
+    /// The smallest value.
+    Min,
+    /// The largest value.
+    Max,
+}
+
+/// A [`Transform`] that aggregates the measurements over fixed time windows.
+///
+/// The time axis is divided into consecutive windows of equal length, aligned on
+/// the UNIX epoch. The points of a window are folded, per (metric, resource,
+/// consumer), into a single point timestamped at the beginning of the window.
+/// The attributes of the input points are discarded.
+///
+/// A window is emitted when a point of a later window arrives for the same key,
+/// or when the key has been inactive for more than one window (so the aggregates
+/// of sources that stop producing, e.g. a terminated process, are not lost).
+///
+/// ## Example
+/// ```no_run
+/// use std::time::Duration;
+/// use alumet::pipeline::aggregation::{AggregationFunction, WindowedAggregation};
+/// # let alumet: &mut alumet::plugin::AlumetStart = todo!();
+/// let aggregation = WindowedAggregation::new(AggregationFunction::Sum, Duration::from_secs(1));
+/// alumet.add_transform(Box::new(aggregation));
+/// ```
+pub struct WindowedAggregation {
+    function: AggregationFunction,
+    window: Duration,
+    /// The opened windows, keyed by (metric, resource, consumer).
+    ///
+    /// The table is preallocated: in steady state (a stable set of keys),
+    /// applying the transform does not allocate.
+    state: HashMap<Key, WindowState, FxBuildHasher>,
+    /// The most recent window index observed so far, used to detect inactive keys.
+    latest_bucket: Option<u64>,
+}
+
+type Key = (RawMetricId, Resource, ResourceConsumer);
+
+/// The running aggregate of one window, for one key.
+struct WindowState {
+    /// Index of the window: timestamp divided by the window length.
+    bucket: u64,
+    /// The folded value: running sum for `Sum` and `Mean`, running extremum for `Min` and `Max`.
+    acc: WrappedMeasurementValue,
+    /// Number of points folded into `acc`.
+    count: u64,
+}
+
+/// Default number of keys that the state table is preallocated for.
+const DEFAULT_KEY_CAPACITY: usize = 256;
+
+impl WindowedAggregation {
+    /// Creates a new aggregation transform.
+    ///
+    /// ## Panics
+    /// Panics if the window is empty.
+    pub fn new(function: AggregationFunction, window: Duration) -> Self {
+        Self::with_expected_keys(function, window, DEFAULT_KEY_CAPACITY)
+    }
+
+    /// Like [`new`](Self::new), but preallocates the state table for the given
+    /// number of distinct (metric, resource, consumer) keys.
+    pub fn with_expected_keys(function: AggregationFunction, window: Duration, expected_keys: usize) -> Self {
+        assert!(!window.is_zero(), "the aggregation window must not be empty");
+        Self {
+            function,
+            window,
+            state: HashMap::with_capacity_and_hasher(expected_keys, FxBuildHasher::default()),
+            latest_bucket: None,
+        }
+    }
+
+    /// Returns the index of the window that contains the given timestamp.
+    fn bucket_of(&self, t: Timestamp) -> u64 {
+        let since_epoch = SystemTime::from(t)
+            .duration_since(SystemTime::UNIX_EPOCH)
+            .unwrap_or_default();
+        (since_epoch.as_nanos() / self.window.as_nanos()) as u64
+    }
+
+    /// Returns the timestamp of the beginning of the given window.
+    fn window_start(&self, bucket: u64) -> Timestamp {
+        let nanos = self.window.as_nanos() * bucket as u128;
+        let secs = (nanos / 1_000_000_000) as u64;
+        let subsec_nanos = (nanos % 1_000_000_000) as u32;
+        Timestamp::from(SystemTime::UNIX_EPOCH + Duration::new(secs, subsec_nanos))
+    }
+
+    /// Builds the aggregated point of a completed window.
+    fn aggregated_point(&self, key: &Key, state: &WindowState) -> MeasurementPoint {
+        let value = match (self.function, &state.acc) {
+            (AggregationFunction::Mean, WrappedMeasurementValue::U64(sum)) => {
+                WrappedMeasurementValue::U64(sum / state.count)
+            }
+            (AggregationFunction::Mean, WrappedMeasurementValue::F64(sum)) => {
+                WrappedMeasurementValue::F64(sum / state.count as f64)
+            }
+            (_, acc) => acc.clone(),
+        };
+        let (metric, resource, consumer) = key;
+        MeasurementPoint::new_untyped(
+            self.window_start(state.bucket),
+            *metric,
+            resource.clone(),
+            consumer.clone(),
+            value,
+        )
+    }
+}
+
+impl WindowState {
+    fn new(bucket: u64, value: &WrappedMeasurementValue) -> Self {
+        Self {
+            bucket,
+            acc: value.clone(),
+            count: 1,
+        }
+    }
+
+    /// Folds one more value into the window.
+    fn accumulate(&mut self, function: AggregationFunction, value: &WrappedMeasurementValue) {
+        use WrappedMeasurementValue::{F64, U64};
+        self.acc = match (&self.acc, value) {
+            (U64(acc), U64(v)) => U64(match function {
+                AggregationFunction::Sum | AggregationFunction::Mean => acc.saturating_add(*v),
+                AggregationFunction::Min => *acc.min(v),
+                AggregationFunction::Max => *acc.max(v),
+            }),
+            (F64(acc), F64(v)) => F64(match function {
+                AggregationFunction::Sum | AggregationFunction::Mean => acc + v,
+                AggregationFunction::Min => acc.min(*v),
+                AggregationFunction::Max => acc.max(*v),
+            }),
+            // A metric has a single value type, so the types cannot mix in practice.
+            // Be defensive anyway: restart the aggregate with the new value.
+            (_, mixed) => {
+                self.count = 0;
+                mixed.clone()
+            }
+        };
+        self.count += 1;
+    }
+}
+
+impl Transform for WindowedAggregation {
+    fn apply(&mut self, measurements: &mut MeasurementBuffer) -> Result<(), TransformError> {
+        let mut completed: Vec<MeasurementPoint> = Vec::new();
+
+        for point in measurements.iter() {
+            let bucket = self.bucket_of(point.timestamp);
+            if self.latest_bucket.map_or(true, |latest| latest < bucket) {
+                self.latest_bucket = Some(bucket);
+            }
+            let key = (point.metric, point.resource.clone(), point.consumer.clone());
+            // The emission is done outside of the match: `aggregated_point` borrows
+            // `self`, which the mutable borrow of `self.state` would not allow.
+            let finished = match self.state.get_mut(&key) {
+                Some(state) if state.bucket == bucket => {
+                    state.accumulate(self.function, &point.value);
+                    None
+                }
+                Some(state) => {
+                    // the window of this key is over, emit it and open the next one
+                    Some(std::mem::replace(state, WindowState::new(bucket, &point.value)))
+                }
+                None => {
+                    self.state.insert(key.clone(), WindowState::new(bucket, &point.value));
+                    None
+                }
+            };
+            if let Some(finished) = finished {
+                completed.push(self.aggregated_point(&key, &finished));
+            }
+        }
+
+        // Emit the windows of the keys that stopped producing measurements.
+        // A key that is more than one full window behind the most recent measurement
+        // cannot receive points anymore (points are at most one flush interval late).
+        if let Some(latest) = self.latest_bucket {
+            // This allocates only when keys actually become inactive, which is rare.
+            let inactive: Vec<Key> = self
+                .state
+                .iter()
+                .filter(|(_, state)| state.bucket + 1 < latest)
+                .map(|(key, _)| key.clone())
+                .collect();
+            for key in inactive {
+                let state = self.state.remove(&key).unwrap();
+                completed.push(self.aggregated_point(&key, &state));
+            }
+        }
+
+        // Replace the input points by the aggregated points of the completed windows.
+        measurements.clear();
+        for point in completed {
+            measurements.push(point);
+        }
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use std::time::{Duration, SystemTime};
+
+    use super::{AggregationFunction, WindowedAggregation};
+    use crate::measurement::{MeasurementBuffer, MeasurementPoint, Timestamp, WrappedMeasurementValue};
+    use crate::metrics::RawMetricId;
+    use crate::pipeline::Transform;
+    use crate::resources::{Resource, ResourceConsumer};
+
+    fn point_at(secs_millis: (u64, u32), value: WrappedMeasurementValue) -> MeasurementPoint {
+        let (secs, millis) = secs_millis;
+        let timestamp = Timestamp::from(SystemTime::UNIX_EPOCH + Duration::new(secs, millis * 1_000_000));
+        MeasurementPoint::new_untyped(
+            timestamp,
+            RawMetricId::from_u64(0),
+            Resource::LocalMachine,
+            ResourceConsumer::LocalMachine,
+            value,
+        )
+    }
+
+    fn apply(transform: &mut WindowedAggregation, points: Vec<MeasurementPoint>) -> MeasurementBuffer {
+        let mut buffer = MeasurementBuffer::from(points);
+        transform.apply(&mut buffer).unwrap();
+        buffer
+    }
+
+    #[test]
+    fn sum_over_one_second_windows() {
+        let mut t = WindowedAggregation::new(AggregationFunction::Sum, Duration::from_secs(1));
+
+        // three points in the window [10s, 11s), nothing to emit yet
+        let out = apply(
+            &mut t,
+            vec![
+                point_at((10, 100), WrappedMeasurementValue::U64(1)),
+                point_at((10, 500), WrappedMeasurementValue::U64(2)),
+                point_at((10, 900), WrappedMeasurementValue::U64(3)),
+            ],
+        );
+        assert!(out.is_empty(), "the window is still open, got {out:?}");
+
+        // a point in the next window closes the previous one
+        let out = apply(&mut t, vec![point_at((11, 200), WrappedMeasurementValue::U64(10))]);
+        assert_eq!(out.len(), 1);
+        let aggregated = out.iter().next().unwrap();
+        assert_eq!(aggregated.value, WrappedMeasurementValue::U64(6));
+        assert_eq!(
+            SystemTime::from(aggregated.timestamp),
+            SystemTime::UNIX_EPOCH + Duration::from_secs(10)
+        );
+
+        // a point far in the future flushes the inactive key
+        let out = apply(&mut t, vec![point_at((20, 0), WrappedMeasurementValue::U64(100))]);
+        assert_eq!(out.len(), 1);
+        assert_eq!(out.iter().next().unwrap().value, WrappedMeasurementValue::U64(10));
+    }
+
+    #[test]
+    fn mean_min_max() {
+        for (function, expected) in [
+            (AggregationFunction::Mean, WrappedMeasurementValue::F64(2.0)),
+            (AggregationFunction::Min, WrappedMeasurementValue::F64(1.0)),
+            (AggregationFunction::Max, WrappedMeasurementValue::F64(3.5)),
+        ] {
+            let mut t = WindowedAggregation::new(function, Duration::from_secs(1));
+            let out = apply(
+                &mut t,
+                vec![
+                    point_at((10, 100), WrappedMeasurementValue::F64(1.0)),
+                    point_at((10, 500), WrappedMeasurementValue::F64(1.5)),
+                    point_at((10, 900), WrappedMeasurementValue::F64(3.5)),
+                    point_at((11, 100), WrappedMeasurementValue::F64(0.0)),
+                ],
+            );
+            assert_eq!(out.len(), 1, "{function:?}");
+            assert_eq!(out.iter().next().unwrap().value, expected, "{function:?}");
+        }
+    }
+}
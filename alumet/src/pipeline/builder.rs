@@ -16,7 +16,7 @@ use tokio_util::sync::CancellationToken;
 use crate::metrics::{Metric, MetricRegistry, RawMetricId};
 use crate::{
     measurement::MeasurementBuffer,
-    pipeline::{Output, Source, Transform},
+    pipeline::{Output, Source, Transform, TransformError},
 };
 
 use super::runtime::{self, IdlePipeline, OutputMsg};
@@ -37,14 +37,32 @@ pub struct PipelineBuilder {
 
     pub(crate) normal_worker_threads: Option<usize>,
     pub(crate) priority_worker_threads: Option<usize>,
+
+    /// Cores that the threads of the "realtime priority" runtime are pinned to.
+    /// Ideally a set of isolated cores (`isolcpus`), so that the measured workloads
+    /// neither perturb the polling cadence nor get perturbed by it.
+    pub(crate) priority_thread_affinity: Option<Vec<u32>>,
+    /// Cores that the threads of the normal runtime are pinned to,
+    /// e.g. to keep them away from the cores reserved for the measured workloads.
+    pub(crate) normal_thread_affinity: Option<Vec<u32>>,
+
+    /// Run each transform in its own task, connected in order by channels,
+    /// instead of running the whole chain in a single task.
+    pub(crate) parallel_transforms: bool,
+
+    /// What the sources do when the channel to the transforms is full.
+    pub(crate) source_overload_policy: runtime::SourceOverloadPolicy,
 }
 
-pub type SourceBuildFn = dyn FnOnce(&PendingPipelineContext) -> Box<dyn Source>;
+// The build closures are `Send` because the plugins can be started concurrently,
+// each one registering its elements from its own thread (see `AgentBuilder::parallel_startup`).
+pub type SourceBuildFn = dyn FnOnce(&PendingPipelineContext) -> Box<dyn Source> + Send;
 pub type AutonomousSourceBuildFn = dyn FnOnce(
-    &PendingPipelineContext,
-    CancellationToken,
-    mpsc::Sender<MeasurementBuffer>,
-) -> Pin<Box<dyn Future<Output = anyhow::Result<()>> + Send>>;
+        &PendingPipelineContext,
+        CancellationToken,
+        mpsc::Sender<MeasurementBuffer>,
+    ) -> Pin<Box<dyn Future<Output = anyhow::Result<()>> + Send>>
+    + Send;
 
 pub struct ManagedSourceBuilder {
     pub name: String,
@@ -62,13 +80,13 @@ pub struct AutonomousSourceBuilder {
 pub struct TransformBuilder {
     pub name: String,
     pub plugin: String,
-    pub build: Box<dyn FnOnce(&PendingPipelineContext) -> Box<dyn Transform>>,
+    pub build: Box<dyn FnOnce(&PendingPipelineContext) -> Box<dyn Transform> + Send>,
 }
 
 pub struct OutputBuilder {
     pub name: String,
     pub plugin: String,
-    pub build: Box<dyn FnOnce(&PendingPipelineContext) -> anyhow::Result<Box<dyn Output>>>,
+    pub build: Box<dyn FnOnce(&PendingPipelineContext) -> anyhow::Result<Box<dyn Output>> + Send>,
 }
 
 /// Information about a pipeline that is being built.
@@ -157,6 +175,94 @@ pub(super) struct ConfiguredOutput {
     pub plugin_name: String,
 }
 
+/// A statically-typed chain of transforms, fused into a single pipeline element.
+///
+/// The runtime stores the pipeline transforms as `Box<dyn Transform>` and checks the
+/// `active_transforms` flags once per transform per buffer. When the chain is known at
+/// compile time, this indirection can be paid only once: wrap the transforms in a tuple
+/// and register the `TransformChain` as a single transform. The chain is invoked through
+/// one virtual call per buffer, and the calls to the individual transforms are statically
+/// dispatched (and can be inlined).
+///
+/// The trade-off is that the chain appears as a single element in the pipeline:
+/// it is enabled and disabled as a whole, not transform by transform.
+/// Dynamically loaded plugins (see [`dynload`](crate::plugin::dynload)) keep using
+/// the boxed path, both can coexist in the same pipeline.
+///
+/// ## Example
+/// ```no_run
+/// use alumet::pipeline::builder::TransformChain;
+/// # use alumet::measurement::MeasurementBuffer;
+/// # use alumet::pipeline::{Transform, TransformError};
+/// # struct A; struct B; struct C;
+/// # impl Transform for A { fn apply(&mut self, m: &mut MeasurementBuffer) -> Result<(), TransformError> { Ok(()) } }
+/// # impl Transform for B { fn apply(&mut self, m: &mut MeasurementBuffer) -> Result<(), TransformError> { Ok(()) } }
+/// # impl Transform for C { fn apply(&mut self, m: &mut MeasurementBuffer) -> Result<(), TransformError> { Ok(()) } }
+/// # let alumet: &mut alumet::plugin::AlumetStart = todo!();
+/// let chain = TransformChain::new((A, B, C));
+/// alumet.add_transform(Box::new(chain));
+/// ```
+pub struct TransformChain<T: StaticTransformChain> {
+    chain: T,
+}
+
+impl<T: StaticTransformChain> TransformChain<T> {
+    /// Creates a new chain from a tuple of transforms, applied in the order of the tuple.
+    pub fn new(chain: T) -> Self {
+        Self { chain }
+    }
+}
+
+impl<T: StaticTransformChain> Transform for TransformChain<T> {
+    fn apply(&mut self, measurements: &mut MeasurementBuffer) -> Result<(), TransformError> {
+        self.chain.apply_all(measurements)
+    }
+}
+
+/// A tuple of [`Transform`]s that can be fused by a [`TransformChain`].
+///
+/// This trait is implemented for tuples of up to 8 transforms.
+/// You should not need to implement it yourself.
+pub trait StaticTransformChain: Send {
+    /// Applies every transform of the chain, in order.
+    ///
+    /// Like the runtime does for boxed transforms, an [`UnexpectedInput`](TransformError::UnexpectedInput)
+    /// error is logged and the rest of the chain still runs, whereas a
+    /// [`Fatal`](TransformError::Fatal) error stops the chain.
+    fn apply_all(&mut self, measurements: &mut MeasurementBuffer) -> Result<(), TransformError>;
+}
+
+macro_rules! impl_static_transform_chain {
+    ( $($T:ident : $idx:tt),+ ) => {
+        impl<$($T: Transform),+> StaticTransformChain for ($($T,)+) {
+            fn apply_all(&mut self, measurements: &mut MeasurementBuffer) -> Result<(), TransformError> {
+                $(
+                    match self.$idx.apply(measurements) {
+                        Ok(()) => (),
+                        Err(TransformError::UnexpectedInput(e)) => {
+                            log::error!(
+                                "Transform {} of a static chain received unexpected measurements: {e:#}",
+                                $idx
+                            );
+                        }
+                        Err(fatal) => return Err(fatal),
+                    }
+                )+
+                Ok(())
+            }
+        }
+    };
+}
+
+impl_static_transform_chain!(T0: 0);
+impl_static_transform_chain!(T0: 0, T1: 1);
+impl_static_transform_chain!(T0: 0, T1: 1, T2: 2);
+impl_static_transform_chain!(T0: 0, T1: 1, T2: 2, T3: 3);
+impl_static_transform_chain!(T0: 0, T1: 1, T2: 2, T3: 3, T4: 4);
+impl_static_transform_chain!(T0: 0, T1: 1, T2: 2, T3: 3, T4: 4, T5: 5);
+impl_static_transform_chain!(T0: 0, T1: 1, T2: 2, T3: 3, T4: 4, T5: 5, T6: 6);
+impl_static_transform_chain!(T0: 0, T1: 1, T2: 2, T3: 3, T4: 4, T5: 5, T6: 6, T7: 7);
+
 #[derive(Debug)]
 pub enum PipelineBuildError {
     /// The pipeline's configuration is invalid.
@@ -222,6 +328,10 @@ impl PipelineBuilder {
             allow_no_metrics: false,
             normal_worker_threads: None,
             priority_worker_threads: None,
+            priority_thread_affinity: None,
+            normal_thread_affinity: None,
+            parallel_transforms: false,
+            source_overload_policy: runtime::SourceOverloadPolicy::default(),
             source_constraints: TriggerConstraints::default(),
         }
     }
@@ -360,6 +470,8 @@ impl PipelineBuilder {
             outputs,
             autonomous_sources,
             autonomous_shutdown_token,
+            parallel_transforms: self.parallel_transforms,
+            source_overload_policy: self.source_overload_policy,
             metrics: self.metrics,
             from_sources: (in_tx, in_rx),
             to_outputs: out_tx,
@@ -378,6 +490,10 @@ impl PipelineBuilder {
         if let Some(n) = self.normal_worker_threads {
             builder.worker_threads(n);
         }
+        if let Some(cpus) = &self.normal_thread_affinity {
+            let cpus = cpus.clone();
+            builder.on_thread_start(move || pin_thread_logged(&cpus));
+        }
         builder.build()
     }
 
@@ -398,11 +514,17 @@ impl PipelineBuilder {
             // but it will be unusable. To avoid that, we store the error here and don't return Some(runtime).
             static THREAD_START_FAILURE: Mutex<Option<io::Error>> = Mutex::new(None);
 
+            let affinity = self.priority_thread_affinity.clone();
             let mut builder = tokio::runtime::Builder::new_multi_thread();
             builder
                 .enable_all()
                 .worker_threads(n_rt_sources)
-                .on_thread_start(|| {
+                .on_thread_start(move || {
+                    // Pin the thread before raising its priority: a pinned SCHED_FIFO thread
+                    // on an isolated core gives the flattest polling latency profile.
+                    if let Some(cpus) = &affinity {
+                        pin_thread_logged(cpus);
+                    }
                     if let Err(e) = super::threading::increase_thread_priority() {
                         let mut failure = THREAD_START_FAILURE.lock().unwrap();
                         if failure.is_none() {
@@ -467,6 +589,18 @@ impl PipelineBuilder {
     }
 }
 
+/// Pins the current thread to the given cpus, logging a warning on failure.
+///
+/// A pinning failure is not fatal: the pipeline works without affinity,
+/// only the measurement jitter suffers.
+fn pin_thread_logged(cpus: &[u32]) {
+    if let Err(e) = super::threading::pin_current_thread(cpus) {
+        let current_thread = std::thread::current();
+        let thread_name = current_thread.name().unwrap_or("<unnamed>");
+        log::warn!("Unable to pin thread {thread_name} to cpus {cpus:?}: {e}");
+    }
+}
+
 /// Generates names for the pipeline elements.
 pub(crate) struct ElementNameGenerator {
     existing_names: HashMap<String, usize>,
@@ -503,3 +637,74 @@ impl Default for ElementNameGenerator {
         Self::new()
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::{StaticTransformChain, TransformChain};
+    use crate::measurement::MeasurementBuffer;
+    use crate::pipeline::{Transform, TransformError};
+
+    /// Counts its applications, and can fail with a configurable error.
+    struct CountingTransform {
+        applied: std::sync::Arc<std::sync::atomic::AtomicU32>,
+        fail_with: Option<fn() -> TransformError>,
+    }
+
+    impl CountingTransform {
+        fn new(applied: &std::sync::Arc<std::sync::atomic::AtomicU32>) -> Self {
+            Self {
+                applied: applied.clone(),
+                fail_with: None,
+            }
+        }
+    }
+
+    impl Transform for CountingTransform {
+        fn apply(&mut self, _measurements: &mut MeasurementBuffer) -> Result<(), TransformError> {
+            self.applied.fetch_add(1, std::sync::atomic::Ordering::Relaxed);
+            match self.fail_with {
+                Some(make_error) => Err(make_error()),
+                None => Ok(()),
+            }
+        }
+    }
+
+    #[test]
+    fn static_transform_chain() {
+        use std::sync::atomic::{AtomicU32, Ordering};
+        use std::sync::Arc;
+
+        let applied_a = Arc::new(AtomicU32::new(0));
+        let applied_b = Arc::new(AtomicU32::new(0));
+        let applied_c = Arc::new(AtomicU32::new(0));
+
+        // The whole chain runs through a single Transform.
+        let mut chain = TransformChain::new((
+            CountingTransform::new(&applied_a),
+            CountingTransform::new(&applied_b),
+            CountingTransform::new(&applied_c),
+        ));
+        let mut buf = MeasurementBuffer::new();
+        chain.apply(&mut buf).expect("the chain should apply fine");
+        chain.apply(&mut buf).expect("the chain should apply fine");
+        assert_eq!(2, applied_a.load(Ordering::Relaxed));
+        assert_eq!(2, applied_b.load(Ordering::Relaxed));
+        assert_eq!(2, applied_c.load(Ordering::Relaxed));
+
+        // An UnexpectedInput error does not stop the chain, like in the dynamic path.
+        let mut failing = CountingTransform::new(&applied_a);
+        failing.fail_with = Some(|| TransformError::UnexpectedInput(anyhow::anyhow!("bad input")));
+        let mut chain = (failing, CountingTransform::new(&applied_b));
+        chain.apply_all(&mut buf).expect("UnexpectedInput should not be fatal");
+        assert_eq!(3, applied_a.load(Ordering::Relaxed));
+        assert_eq!(3, applied_b.load(Ordering::Relaxed));
+
+        // A Fatal error stops the chain.
+        let mut failing = CountingTransform::new(&applied_a);
+        failing.fail_with = Some(|| TransformError::Fatal(anyhow::anyhow!("broken")));
+        let mut chain = (failing, CountingTransform::new(&applied_b));
+        chain.apply_all(&mut buf).expect_err("Fatal errors should propagate");
+        assert_eq!(4, applied_a.load(Ordering::Relaxed));
+        assert_eq!(3, applied_b.load(Ordering::Relaxed), "the chain should stop on a fatal error");
+    }
+}
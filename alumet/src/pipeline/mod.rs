@@ -1,11 +1,14 @@
 //! Asynchronous and modular measurement pipeline.
 
 use std::fmt;
+use std::sync::Arc;
 
 use crate::{measurement::{MeasurementAccumulator, MeasurementBuffer, Timestamp}, metrics::MetricRegistry};
 
+pub mod aggregation;
 pub mod runtime;
 pub mod builder;
+pub mod stats;
 mod threading;
 mod scoped;
 pub mod trigger;
@@ -29,7 +32,10 @@ pub trait Output: Send {
 }
 
 pub struct OutputContext {
-    pub metrics: MetricRegistry,
+    /// Read-only snapshot of the metric registry, shared by all the outputs.
+    ///
+    /// Late metric registration is copy-on-write: see `OutputMsg::RegisterMetrics`.
+    pub metrics: Arc<MetricRegistry>,
 }
 
 // ====== Errors ======
@@ -4,7 +4,7 @@ use std::collections::HashMap;
 use std::ops::BitOrAssign;
 use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::Arc;
-use std::time::Duration;
+use std::time::{Duration, Instant};
 
 use anyhow::{anyhow, Context};
 
@@ -19,9 +19,10 @@ use tokio_util::sync::CancellationToken;
 use crate::measurement::Timestamp;
 use crate::metrics::{Metric, RawMetricId};
 use crate::pipeline::scoped;
+use crate::pipeline::stats::PIPELINE_STATS;
 use crate::pipeline::trigger::TriggerReason;
 use crate::{
-    measurement::MeasurementBuffer,
+    measurement::{BufferPool, MeasurementBuffer},
     metrics::MetricRegistry,
     pipeline::{Output, Source},
 };
@@ -42,6 +43,12 @@ pub struct IdlePipeline {
     // Cancellation token to implement the graceful shutdown of autonomous sources.
     pub(super) autonomous_shutdown_token: CancellationToken,
 
+    // If true, run each transform in its own task (see `run_transform_stage`).
+    pub(super) parallel_transforms: bool,
+
+    // What the sources do when the channel to the transforms is full.
+    pub(super) source_overload_policy: SourceOverloadPolicy,
+
     // tokio Runtimes that execute the tasks
     pub(super) rt_normal: Runtime,
     pub(super) rt_priority: Option<Runtime>,
@@ -65,6 +72,10 @@ enum ControlMessage {
         source: Box<dyn Source>,
         trigger: TriggerSpec,
     },
+    RemoveSource {
+        requested_name: String,
+        plugin_name: String,
+    },
     ModifySource(ElementCommand<SourceCmd>),
     ModifyTransform(ElementCommand<TransformCmd>),
     ModifyOutput(ElementCommand<OutputCmd>),
@@ -106,7 +117,9 @@ struct PipelineControllerState {
     global_shutdown_send: UnboundedSender<()>,
 
     // Senders to keep the receivers alive and to send commands.
-    source_command_senders_by_plugin: HashMap<String, Vec<watch::Sender<SourceCmd>>>,
+    // Each source sender is stored with the name of its source (or source group),
+    // so that commands can also target one source in particular (see ControlMessage::RemoveSource).
+    source_command_senders_by_plugin: HashMap<String, Vec<(String, watch::Sender<SourceCmd>)>>,
     output_command_senders_by_plugin: HashMap<String, Vec<watch::Sender<OutputCmd>>>,
 
     /// Currently active transforms.
@@ -134,6 +147,9 @@ struct PipelineModifierState {
     /// Sends measurements from Sources.
     in_tx: mpsc::Sender<MeasurementBuffer>,
 
+    /// What the sources do when `in_tx` is full (same policy as the initial sources).
+    source_overload_policy: SourceOverloadPolicy,
+
     /// Handle to the tokio runtime with "normal" threads.
     rt_normal: tokio::runtime::Handle,
 }
@@ -172,14 +188,15 @@ impl IdlePipeline {
         let (in_tx, in_rx) = self.from_sources;
 
         // 1. Outputs
+        // All the output tasks share one immutable snapshot of the MetricRegistry.
+        // This allows fast, uncontended access to the registry (no Arc<Mutex<...>>),
+        // without duplicating it per output: late metric registration is copy-on-write.
+        let shared_metrics = Arc::new(self.metrics);
         for out in self.outputs {
             let msg_rx = self.to_outputs.subscribe();
             let (command_tx, command_rx) = watch::channel(OutputCmd::Run);
             let ctx = OutputContext {
-                // Each output task owns its OutputContext, which contains a copy of the MetricRegistry.
-                // This allows fast, uncontended access to the registry, and avoids a global state (no Arc<Mutex<...>>).
-                // The cost is a duplication of the registry (increased memory use) in the case where multiple outputs exist.
-                metrics: self.metrics.clone(),
+                metrics: shared_metrics.clone(),
             };
 
             // Store command_tx so that we can accept commands later (commands can target the outputs of a specific plugin).
@@ -193,7 +210,7 @@ impl IdlePipeline {
             output_set.spawn_on(task, self.rt_normal.handle());
         }
 
-        // 2. Transforms (all in the same task because they are applied one after another)
+        // 2. Transforms
         let active_transforms = Arc::new(AtomicU64::new(u64::MAX)); // all active by default
         for (i, t) in self.transforms.iter().enumerate() {
             let mask: u64 = 1 << i;
@@ -202,11 +219,82 @@ impl IdlePipeline {
                 .or_default()
                 .bitor_assign(mask);
         }
-        let transforms_task = run_transforms(self.transforms, in_rx, self.to_outputs, active_transforms.clone());
-        transform_set.spawn_on(transforms_task, self.rt_normal.handle());
+        if self.parallel_transforms && self.transforms.len() > 1 {
+            // Parallel mode: each transform runs in its own task, the tasks are chained
+            // in registration order by bounded channels. The buffers flow through every
+            // stage in order, so the outputs still see flush-ordered measurements, and
+            // each transform keeps exclusive access to its state (no locking).
+            let mut transforms = self.transforms;
+            let last_index = transforms.len() - 1;
+            let last = transforms.pop().unwrap();
+            let mut stage_rx = in_rx;
+            for (i, t) in transforms.into_iter().enumerate() {
+                let (next_tx, next_rx) = mpsc::channel::<MeasurementBuffer>(TRANSFORM_STAGE_CHANNEL_SIZE);
+                let task = run_transform_stage(i, t, stage_rx, next_tx, active_transforms.clone());
+                transform_set.spawn_on(task, self.rt_normal.handle());
+                stage_rx = next_rx;
+            }
+            let task = run_transform_stage_final(last_index, last, stage_rx, self.to_outputs, active_transforms.clone());
+            transform_set.spawn_on(task, self.rt_normal.handle());
+        } else {
+            // Sequential mode: all the transforms in the same task, applied one after another.
+            let transforms_task = run_transforms(self.transforms, in_rx, self.to_outputs, active_transforms.clone());
+            transform_set.spawn_on(transforms_task, self.rt_normal.handle());
+        }
 
         // 3. Managed sources
+        // Sources that asked for trigger coalescing (see `TimeTriggerBuilder::coalesce`) are
+        // grouped by plugin and compatible trigger: each group shares one timer, one task
+        // and one buffer, instead of one of each per source.
+        let mut groups: Vec<(String, TriggerSpec, Vec<(String, Box<dyn Source>)>)> = Vec::new();
+        let mut standalone: Vec<builder::ConfiguredSource> = Vec::new();
         for src in self.sources {
+            if src.trigger_provider.coalesce {
+                match groups.iter_mut().find(|(plugin, spec, _)| {
+                    *plugin == src.plugin_name && spec.can_coalesce_with(&src.trigger_provider)
+                }) {
+                    Some((_, _, sources)) => sources.push((src.name, src.source)),
+                    None => groups.push((src.plugin_name, src.trigger_provider, vec![(src.name, src.source)])),
+                }
+            } else {
+                standalone.push(src);
+            }
+        }
+        // A plugin can produce several groups (incompatible triggers): number them
+        // so that their names stay unique, otherwise RemoveSource name-matching
+        // would stop all the groups of the plugin at once.
+        let mut group_counts: HashMap<String, usize> = HashMap::new();
+        for (plugin_name, trigger_provider, mut sources) in groups {
+            if sources.len() == 1 {
+                // a group of one source gains nothing, run it like a normal source
+                let (name, source) = sources.pop().unwrap();
+                standalone.push(builder::ConfiguredSource {
+                    source,
+                    name,
+                    plugin_name,
+                    trigger_provider,
+                });
+                continue;
+            }
+            let data_tx = in_tx.clone();
+            let runtime = match trigger_provider.realtime_priority {
+                true => self.rt_priority.as_ref().unwrap_or(&self.rt_normal),
+                false => &self.rt_normal,
+            };
+            let group_idx = group_counts.entry(plugin_name.clone()).or_default();
+            let group_name = format!("{}/coalesced-sources-{}", plugin_name, group_idx);
+            *group_idx += 1;
+            log::debug!("Coalescing {} sources of plugin {plugin_name} onto a shared timer.", sources.len());
+            let (command_tx, command_rx) = watch::channel(SourceCmd::SetTrigger(Some(trigger_provider)));
+            source_command_senders_by_plugin
+                .entry(plugin_name)
+                .or_default()
+                .push((group_name.clone(), command_tx));
+
+            let task = run_source_group(group_name, sources, data_tx, command_rx, self.source_overload_policy);
+            source_set.spawn_on(task, runtime.handle());
+        }
+        for src in standalone {
             let data_tx = in_tx.clone();
             let runtime = match src.trigger_provider.realtime_priority {
                 true => self.rt_priority.as_ref().unwrap_or(&self.rt_normal),
@@ -216,9 +304,9 @@ impl IdlePipeline {
             source_command_senders_by_plugin
                 .entry(src.plugin_name)
                 .or_default()
-                .push(command_tx);
+                .push((src.name.clone(), command_tx));
 
-            let task = run_source(src.name, src.source, data_tx, command_rx);
+            let task = run_source(src.name, src.source, data_tx, command_rx, self.source_overload_policy);
             source_set.spawn_on(task, runtime.handle());
         }
 
@@ -258,6 +346,7 @@ impl IdlePipeline {
                 namegen: builder::ElementNameGenerator::new(),
                 join_sets,
                 in_tx,
+                source_overload_policy: self.source_overload_policy,
                 rt_normal: self.rt_normal.handle().clone(),
             },
         };
@@ -293,23 +382,92 @@ pub enum SourceCmd {
     SetTrigger(Option<TriggerSpec>),
 }
 
+/// What to do when a source flushes its measurements but the (bounded) channel
+/// to the transforms is full, because the downstream stages cannot keep up
+/// (e.g. an output waits for an unreachable database).
+///
+/// The policy never blocks the source task: the polling cadence is preserved
+/// even under pressure, which matters for sources that must not miss a
+/// measurement window (e.g. energy counters that wrap around).
+/// What the policy controls is which measurements get shed, and when.
+///
+/// See [`crate::agent::AgentBuilder::source_overload_policy`].
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum SourceOverloadPolicy {
+    /// Keep the measurements in the source's buffer and retry at the next flush,
+    /// sending them as one bigger batch once the channel has room again.
+    ///
+    /// Nothing is lost during a transient stall. If the downstream stages are
+    /// stuck for so long that the retained measurements exceed `max_points`,
+    /// the oldest ones are discarded first.
+    Coalesce {
+        /// Maximum number of measurement points retained per source.
+        max_points: usize,
+    },
+    /// Immediately discard the measurements that could not be flushed.
+    ///
+    /// Memory usage stays minimal, at the cost of losing every measurement
+    /// produced while the pipeline is overloaded.
+    DropNew,
+}
+
+impl Default for SourceOverloadPolicy {
+    fn default() -> Self {
+        // Survive transient output stalls without losing anything, shed the
+        // oldest points on long outages to bound the memory usage.
+        SourceOverloadPolicy::Coalesce { max_points: 100_000 }
+    }
+}
+
+/// Applies the overload policy to a buffer that could not be flushed because
+/// the channel to the transforms is full.
+///
+/// Returns the buffer that the source continues to poll into.
+/// `overloaded` tracks the overload state across flushes, to log the beginning
+/// of an overload once instead of on every failed flush.
+fn apply_overload_policy(
+    name: &str,
+    policy: SourceOverloadPolicy,
+    mut buffer: MeasurementBuffer,
+    overloaded: &mut bool,
+) -> MeasurementBuffer {
+    if !*overloaded {
+        log::warn!("The pipeline cannot keep up with {name}, applying the overload policy {policy:?}.");
+        *overloaded = true;
+    }
+    match policy {
+        SourceOverloadPolicy::Coalesce { max_points } => {
+            if buffer.len() > max_points {
+                let dropped = buffer.len() - max_points;
+                buffer.retain_latest(max_points);
+                log::warn!("{name} retained more than {max_points} measurements, dropped the {dropped} oldest.");
+            }
+        }
+        SourceOverloadPolicy::DropNew => {
+            buffer.clear();
+        }
+    }
+    buffer
+}
+
+/// Takes the [`Trigger`] from the option and initializes it.
+fn init_trigger(
+    trigger_spec: &mut Option<TriggerSpec>,
+    interrupt_signal: watch::Receiver<SourceCmd>,
+) -> Result<Trigger, std::io::Error> {
+    let spec = trigger_spec
+        .take()
+        .expect("invalid empty trigger in message Init(trigger)");
+    Trigger::new(spec, interrupt_signal)
+}
+
 async fn run_source(
     source_name: String,
     mut source: Box<dyn Source>,
     tx: mpsc::Sender<MeasurementBuffer>,
     mut commands: watch::Receiver<SourceCmd>,
+    overload_policy: SourceOverloadPolicy,
 ) -> anyhow::Result<()> {
-    /// Takes the [`Trigger`] from the option and initializes it.
-    fn init_trigger(
-        trigger_spec: &mut Option<TriggerSpec>,
-        interrupt_signal: watch::Receiver<SourceCmd>,
-    ) -> Result<Trigger, std::io::Error> {
-        let spec = trigger_spec
-            .take()
-            .expect("invalid empty trigger in message Init(trigger)");
-        Trigger::new(spec, interrupt_signal)
-    }
-
     // the first command must be "init"
     let mut trigger: Trigger = {
         let signal = commands.clone();
@@ -328,8 +486,14 @@ async fn run_source(
     };
 
     // Store measurements in this buffer, and replace it every `flush_rounds` rounds.
+    // The buffers come from a pool: when the last output is done with a flushed buffer,
+    // its allocation returns to the pool and is reused by a later cycle (no steady-state allocation).
     // For now, we don't know how many measurements the source will produce, so we allocate 1 per round.
-    let mut buffer = MeasurementBuffer::with_capacity(trigger.config.flush_rounds);
+    let buffer_pool = BufferPool::new();
+    let mut buffer = buffer_pool.get(trigger.config.flush_rounds);
+
+    // Whether the last flush failed because the channel was full (see `apply_overload_policy`).
+    let mut overloaded = false;
 
     // main loop
     let mut i = 1usize;
@@ -341,9 +505,39 @@ async fn run_source(
 
         let update = match reason {
             TriggerReason::Triggered => {
-                // poll the source
-                let timestamp = Timestamp::now();
-                match source.poll(&mut buffer.as_accumulator(), timestamp) {
+                // poll the source, with a coarse timestamp if the trigger asks for it
+                let timestamp = if trigger.config.coarse_timestamps {
+                    Timestamp::now_coarse()
+                } else {
+                    Timestamp::now()
+                };
+                let poll_start = Instant::now();
+                let poll_res = if trigger.config.blocking_poll {
+                    // The source does blocking I/O: poll it on the blocking thread pool,
+                    // so that a slow poll does not stall this async worker and the
+                    // unrelated sources that share it. See the `scoped` module.
+                    let res = scoped::spawn_blocking_with(source.as_mut(), &mut buffer, move |source, buffer| {
+                        source.poll(&mut buffer.as_accumulator(), timestamp)
+                    })
+                    .await;
+                    match res {
+                        Ok(poll_res) => poll_res,
+                        Err(await_err) => {
+                            if await_err.is_panic() {
+                                return Err(anyhow!(
+                                    "A blocking polling task panicked, there is a bug somewhere! Details: {}",
+                                    await_err
+                                ));
+                            } else {
+                                todo!("unhandled error");
+                            }
+                        }
+                    }
+                } else {
+                    source.poll(&mut buffer.as_accumulator(), timestamp)
+                };
+                PIPELINE_STATS.record_poll(poll_start.elapsed());
+                match poll_res {
                     Ok(()) => (),
                     Err(PollError::CanRetry(e)) => {
                         log::error!("Non-fatal error when polling {source_name} (will retry): {e:#}");
@@ -365,20 +559,26 @@ async fn run_source(
 
                     buffer = match tx.try_send(buffer) {
                         Ok(()) => {
-                            // buffer has been sent, create a new one
+                            // buffer has been sent, check a new one out of the pool
                             log::debug!("{source_name} flushed {prev_length} measurements");
-                            MeasurementBuffer::with_capacity(prev_length)
+                            PIPELINE_STATS.record_flush(prev_length, tx.max_capacity() - tx.capacity());
+                            // in adaptive flush mode, adjust the cadence to the observed flush size
+                            trigger.config.adapt_flush_rounds(prev_length);
+                            if overloaded {
+                                log::info!("The pipeline caught up, {source_name} flushes normally again.");
+                                overloaded = false;
+                            }
+                            buffer_pool.get(prev_length)
                         }
                         Err(TrySendError::Closed(_buf)) => {
                             // the channel Receiver has been closed
                             panic!("source channel should stay open");
                         }
-                        Err(TrySendError::Full(_buf)) => {
-                            // the channel's buffer is full! reduce the measurement frequency
-                            // TODO it would be better to choose which source to slow down based
-                            // on its frequency and number of measurements per poll.
-                            // buf
-                            todo!("buffer is full")
+                        Err(TrySendError::Full(buf)) => {
+                            // The channel is full: downstream is too slow.
+                            // Never block here, that would perturb the polling cadence:
+                            // apply the overload policy and continue polling on time.
+                            apply_overload_policy(&source_name, overload_policy, buf, &mut overloaded)
                         }
                     };
                 }
@@ -459,12 +659,242 @@ async fn run_source(
     Ok(())
 }
 
+/// Polls every source of a coalesced group, back-to-back and with the same timestamp.
+///
+/// A source that fails with a fatal error is removed from the group.
+fn poll_source_group(
+    sources: &mut Vec<(String, Box<dyn Source>)>,
+    buffer: &mut MeasurementBuffer,
+    timestamp: Timestamp,
+    group_name: &str,
+) {
+    sources.retain_mut(|(source_name, source)| {
+        let poll_start = Instant::now();
+        let poll_res = source.poll(&mut buffer.as_accumulator(), timestamp);
+        PIPELINE_STATS.record_poll(poll_start.elapsed());
+        match poll_res {
+            Ok(()) => true,
+            Err(PollError::CanRetry(e)) => {
+                log::error!("Non-fatal error when polling {source_name} (will retry): {e:#}");
+                true
+            }
+            Err(PollError::Fatal(e)) => {
+                log::error!(
+                    "Fatal error when polling {source_name}, it is removed from the group {group_name}: {e:?}"
+                );
+                false
+            }
+        }
+    });
+}
+
+/// Runs a group of coalesced sources on a single shared timer.
+///
+/// On each tick, the sources are polled back-to-back, with the same timestamp,
+/// into a shared buffer that is flushed downstream as one batch.
+/// This behaves like [`run_source`], with two differences:
+/// - the commands of the watch channel apply to the whole group;
+/// - a fatal polling error removes the failing source from the group instead of
+///   stopping the task (the task only stops when the group becomes empty).
+async fn run_source_group(
+    group_name: String,
+    mut sources: Vec<(String, Box<dyn Source>)>,
+    tx: mpsc::Sender<MeasurementBuffer>,
+    mut commands: watch::Receiver<SourceCmd>,
+    overload_policy: SourceOverloadPolicy,
+) -> anyhow::Result<()> {
+    // the first command must be "init"
+    let mut trigger: Trigger = {
+        let signal = commands.clone();
+        let init_cmd = commands
+            .wait_for(|c| matches!(c, SourceCmd::SetTrigger(_)))
+            .await
+            .expect("watch channel must stay open during run_source_group");
+
+        // cloning required to borrow opt as mut below
+        match init_cmd.clone() {
+            SourceCmd::SetTrigger(mut opt) => {
+                init_trigger(&mut opt, signal).with_context(|| format!("init_trigger failed for {group_name}"))?
+            }
+            _ => unreachable!(),
+        }
+    };
+
+    // Store measurements in this buffer, and replace it every `flush_rounds` rounds.
+    // Like in run_source, the buffers come from a pool that recycles their allocations,
+    // and we assume 1 measurement per source per round until the first flush.
+    let buffer_pool = BufferPool::new();
+    let mut buffer = buffer_pool.get(trigger.config.flush_rounds * sources.len());
+
+    // Whether the last flush failed because the channel was full (see `apply_overload_policy`).
+    let mut overloaded = false;
+
+    // main loop
+    let mut i = 1usize;
+    'run: loop {
+        let reason = trigger.next().await.with_context(|| group_name.clone())?;
+
+        let update = match reason {
+            TriggerReason::Triggered => {
+                // poll every source of the group, back-to-back and with the same timestamp
+                let timestamp = if trigger.config.coarse_timestamps {
+                    Timestamp::now_coarse()
+                } else {
+                    Timestamp::now()
+                };
+                if trigger.config.blocking_poll {
+                    // Like in run_source, blocking sources are polled on the blocking thread pool.
+                    let name = group_name.clone();
+                    let res = scoped::spawn_blocking_with(&mut sources, &mut buffer, move |sources, buffer| {
+                        poll_source_group(sources, buffer, timestamp, &name)
+                    })
+                    .await;
+                    if let Err(await_err) = res {
+                        if await_err.is_panic() {
+                            return Err(anyhow!(
+                                "A blocking polling task panicked, there is a bug somewhere! Details: {}",
+                                await_err
+                            ));
+                        } else {
+                            todo!("unhandled error");
+                        }
+                    }
+                } else {
+                    poll_source_group(&mut sources, &mut buffer, timestamp, &group_name);
+                }
+                if sources.is_empty() {
+                    log::warn!("All the sources of the group {group_name} have stopped, the group will stop.");
+                    if !buffer.is_empty() {
+                        let _ = tx.try_send(buffer);
+                    }
+                    break 'run;
+                }
+
+                // Flush the measurements of the whole group in a single send.
+                if i % trigger.config.flush_rounds == 0 {
+                    let prev_length = buffer.len();
+
+                    buffer = match tx.try_send(buffer) {
+                        Ok(()) => {
+                            log::debug!("{group_name} flushed {prev_length} measurements");
+                            PIPELINE_STATS.record_flush(prev_length, tx.max_capacity() - tx.capacity());
+                            // in adaptive flush mode, adjust the cadence to the observed flush size
+                            trigger.config.adapt_flush_rounds(prev_length);
+                            if overloaded {
+                                log::info!("The pipeline caught up, {group_name} flushes normally again.");
+                                overloaded = false;
+                            }
+                            buffer_pool.get(prev_length)
+                        }
+                        Err(TrySendError::Closed(_buf)) => {
+                            panic!("source channel should stay open");
+                        }
+                        Err(TrySendError::Full(buf)) => {
+                            // see the same case in run_source
+                            apply_overload_policy(&group_name, overload_policy, buf, &mut overloaded)
+                        }
+                    };
+                }
+
+                let update = (i % trigger.config.update_rounds) == 0;
+                i = i.wrapping_add(1);
+                update
+            }
+            TriggerReason::Interrupted => true,
+        };
+
+        if update {
+            // update state based on the latest command, which applies to the whole group
+            let current_command: Option<SourceCmd> = {
+                let cmd_ref = commands.borrow_and_update();
+                if cmd_ref.has_changed() {
+                    Some(cmd_ref.clone())
+                } else {
+                    None
+                }
+            };
+
+            if let Some(cmd) = current_command {
+                let mut cmd = cmd;
+                let mut paused = false;
+                'pause: loop {
+                    log::trace!("{group_name} received {cmd:?}");
+                    match cmd {
+                        SourceCmd::Run => break 'pause,
+                        SourceCmd::Pause => paused = true,
+                        SourceCmd::Stop => {
+                            // flush now, then stop
+                            if !buffer.is_empty() {
+                                tx.try_send(buffer)
+                                    .expect("failed to flush measurements after receiving SourceCmd::Stop");
+                            }
+                            break 'run;
+                        }
+                        SourceCmd::SetTrigger(mut opt) => {
+                            let prev_flush_rounds = trigger.config.flush_rounds;
+
+                            // update the shared trigger
+                            let signal = commands.clone();
+                            trigger = init_trigger(&mut opt, signal).unwrap();
+
+                            // estimate the required buffer capacity and allocate it
+                            let prev_length = buffer.len();
+                            let remaining_rounds = trigger.config.flush_rounds;
+                            let hint_additional_elems = remaining_rounds * prev_length / prev_flush_rounds;
+                            buffer.reserve(hint_additional_elems);
+
+                            // don't be stuck here
+                            if !paused {
+                                break 'pause;
+                            }
+                        }
+                    }
+                    commands
+                        .changed()
+                        .await
+                        .expect("command channel of paused source group should remain open");
+                    cmd = commands.borrow().clone();
+                }
+            }
+        }
+    }
+    Ok(())
+}
+
 #[derive(Debug)]
 pub enum TransformCmd {
     Enable,
     Disable,
 }
 
+/// Applies one transform to the buffer, if it is enabled, mapping the errors like [`run_transforms`].
+///
+/// If one of the transforms fails, the ability to continue running depends on the error type.
+fn apply_transform(
+    t: &mut ConfiguredTransform,
+    t_flag: u64,
+    measurements: &mut MeasurementBuffer,
+    active_flags: &AtomicU64,
+) -> anyhow::Result<()> {
+    // The PipelineController can update the flags.
+    if active_flags.load(Ordering::Relaxed) & t_flag != 0 {
+        match t.transform.apply(measurements) {
+            Ok(()) => (),
+            Err(TransformError::UnexpectedInput(e)) => {
+                log::error!("Transform function {} received unexpected measurements: {e:#}", t.name);
+            }
+            Err(TransformError::Fatal(e)) => {
+                log::error!(
+                    "Fatal error in transform {} (this breaks the transform task!): {e:?}",
+                    t.name
+                );
+                return Err(e.context(format!("fatal error in transform {}", t.name)));
+            }
+        }
+    }
+    Ok(())
+}
+
 async fn run_transforms(
     mut transforms: Vec<ConfiguredTransform>,
     mut rx: mpsc::Receiver<MeasurementBuffer>,
@@ -473,31 +903,17 @@ async fn run_transforms(
 ) -> anyhow::Result<()> {
     loop {
         if let Some(mut measurements) = rx.recv().await {
-            // Update the list of active transforms (the PipelineController can update the flags).
-            let current_flags = active_flags.load(Ordering::Relaxed);
-
-            // Run the enabled transforms. If one of them fails, the ability to continue running depends on the error type.
+            // Run the enabled transforms.
+            let transform_start = Instant::now();
             for (i, t) in &mut transforms.iter_mut().enumerate() {
-                let t_flag = 1 << i;
-                if current_flags & t_flag != 0 {
-                    match t.transform.apply(&mut measurements) {
-                        Ok(()) => (),
-                        Err(TransformError::UnexpectedInput(e)) => {
-                            log::error!("Transform function {} received unexpected measurements: {e:#}", t.name);
-                        }
-                        Err(TransformError::Fatal(e)) => {
-                            log::error!(
-                                "Fatal error in transform {} (this breaks the transform task!): {e:?}",
-                                t.name
-                            );
-                            return Err(e.context(format!("fatal error in transform {}", t.name)));
-                        }
-                    }
-                }
+                apply_transform(t, 1 << i, &mut measurements, &active_flags)?;
             }
+            PIPELINE_STATS.record_transform(transform_start.elapsed());
 
             // Send the results to the outputs.
-            tx.send(OutputMsg::WriteMeasurements(measurements))
+            // The buffer is frozen into an Arc: the broadcast clones a pointer per output,
+            // not the points themselves (outputs only read the measurements).
+            tx.send(OutputMsg::WriteMeasurements(Arc::new(measurements)))
                 .context("could not send the measurements from transforms to the outputs")?;
         } else {
             log::debug!("The channel connected to the transform step has been closed, the transforms will stop.");
@@ -507,6 +923,65 @@ async fn run_transforms(
     Ok(())
 }
 
+/// Capacity of the channels between two transform stages, in parallel mode.
+///
+/// A few buffers of slack let the stages work on different buffers at the same time,
+/// without accumulating an unbounded backlog if one stage is slower than the sources.
+const TRANSFORM_STAGE_CHANNEL_SIZE: usize = 8;
+
+/// Runs one stage of a parallel transform chain (see `PipelineBuilder::parallel_transforms`).
+///
+/// Each stage applies a single transform and passes the buffer on to the next stage,
+/// so the stages process different buffers concurrently (pipeline parallelism) while
+/// the buffers traverse the chain in flush order.
+async fn run_transform_stage(
+    stage_index: usize,
+    mut t: ConfiguredTransform,
+    mut rx: mpsc::Receiver<MeasurementBuffer>,
+    tx: mpsc::Sender<MeasurementBuffer>,
+    active_flags: Arc<AtomicU64>,
+) -> anyhow::Result<()> {
+    loop {
+        if let Some(mut measurements) = rx.recv().await {
+            let transform_start = Instant::now();
+            apply_transform(&mut t, 1 << stage_index, &mut measurements, &active_flags)?;
+            PIPELINE_STATS.record_transform(transform_start.elapsed());
+            if tx.send(measurements).await.is_err() {
+                log::debug!("The next transform stage after {} has stopped, stopping too.", t.name);
+                break;
+            }
+        } else {
+            log::debug!("The channel connected to transform stage {} has been closed, it will stop.", t.name);
+            break;
+        }
+    }
+    Ok(())
+}
+
+/// Runs the last stage of a parallel transform chain: applies the transform
+/// and broadcasts the buffer to the outputs, like [`run_transforms`] does.
+async fn run_transform_stage_final(
+    stage_index: usize,
+    mut t: ConfiguredTransform,
+    mut rx: mpsc::Receiver<MeasurementBuffer>,
+    tx: broadcast::Sender<OutputMsg>,
+    active_flags: Arc<AtomicU64>,
+) -> anyhow::Result<()> {
+    loop {
+        if let Some(mut measurements) = rx.recv().await {
+            let transform_start = Instant::now();
+            apply_transform(&mut t, 1 << stage_index, &mut measurements, &active_flags)?;
+            PIPELINE_STATS.record_transform(transform_start.elapsed());
+            tx.send(OutputMsg::WriteMeasurements(Arc::new(measurements)))
+                .context("could not send the measurements from transforms to the outputs")?;
+        } else {
+            log::debug!("The channel connected to transform stage {} has been closed, it will stop.", t.name);
+            break;
+        }
+    }
+    Ok(())
+}
+
 /// A command for an output.
 #[derive(Debug, Clone, PartialEq, Eq)]
 pub enum OutputCmd {
@@ -517,7 +992,9 @@ pub enum OutputCmd {
 
 #[derive(Debug, Clone)]
 pub enum OutputMsg {
-    WriteMeasurements(MeasurementBuffer),
+    /// Measurements to write, behind an [`Arc`] so that the broadcast to the
+    /// subscribed outputs does not deep-copy the buffer once per output.
+    WriteMeasurements(Arc<MeasurementBuffer>),
     RegisterMetrics {
         metrics: Vec<Metric>,
         source_name: String,
@@ -559,9 +1036,11 @@ async fn run_output_from_broadcast(
                 // Output is not Sync, we could move the value to the future and back (idem for ctx),
                 // but that would likely introduce a needless copy, and would be cumbersome to work with.
                 // Instead, we use the `scoped` module.
+                let write_start = Instant::now();
                 let res =
                     scoped::spawn_blocking_with_output(output, ctx, move |out, ctx| out.write(&measurements, ctx))
                         .await;
+                PIPELINE_STATS.record_write(write_start.elapsed());
                 match res {
                     Ok(write_res) => {
                         match write_res {
@@ -594,7 +1073,9 @@ async fn run_output_from_broadcast(
                 source_name,
                 reply_to,
             } => {
-                let metric_ids = ctx.metrics.extend_infallible(metrics, &source_name);
+                // Copy-on-write: the shared snapshot is cloned (once per output) only when
+                // metrics are registered late, the hot path stays a plain Arc deref.
+                let metric_ids = Arc::make_mut(&mut ctx.metrics).extend_infallible(metrics, &source_name);
                 reply_to.send(metric_ids).await?;
                 Ok(())
             }
@@ -634,6 +1115,7 @@ async fn run_output_from_broadcast(
                         handle_message(msg, &output_name, output.as_mut(), &mut ctx).await?;
                     },
                     Err(broadcast::error::RecvError::Lagged(n)) => {
+                        PIPELINE_STATS.record_output_lag(n);
                         log::warn!("Output {output_name} is too slow, it lost the oldest {n} messages.");
                     },
                     Err(broadcast::error::RecvError::Closed) => {
@@ -771,7 +1253,7 @@ async fn pipeline_control_task(
         .source_command_senders_by_plugin
         .values()
         .flatten()
-        .cloned()
+        .map(|(_, sender)| sender.clone())
         .collect();
     let output_command_senders: Vec<watch::Sender<OutputCmd>> = state
         .output_command_senders_by_plugin
@@ -842,25 +1324,64 @@ fn handle_control_message(state: &mut PipelineControllerState, message: ControlM
                 .source_command_senders_by_plugin
                 .entry(plugin)
                 .or_default()
-                .push(command_tx);
+                .push((source_name.clone(), command_tx));
 
             // submit the task to the tokio Runtime, unless we are shutting down
-            let task = run_source(source_name, source, in_tx, command_rx);
+            let task = run_source(source_name, source, in_tx, command_rx, modif.source_overload_policy);
             modif.join_sets.source_set.spawn_on(task, &modif.rt_normal);
         }
 
+        ControlMessage::RemoveSource {
+            requested_name,
+            plugin_name: plugin,
+        } => {
+            // The full name of a source added at runtime is "{plugin}/{requested_name}" (see AddSource),
+            // possibly with a "-N" suffix if the same name was requested several times
+            // (e.g. a k8s pod that was deleted and then recreated).
+            let source_name = format!("{plugin}/{requested_name}");
+            fn name_matches(name: &str, source_name: &str) -> bool {
+                match name.strip_prefix(source_name) {
+                    Some("") => true,
+                    Some(suffix) => {
+                        let mut chars = suffix.chars();
+                        chars.next() == Some('-') && chars.as_str().chars().all(|c| c.is_ascii_digit())
+                    }
+                    None => false,
+                }
+            }
+            log::debug!("Removing source {source_name}");
+
+            let mut found = false;
+            if let Some(senders) = state.source_command_senders_by_plugin.get_mut(&plugin) {
+                senders.retain(|(name, sender)| {
+                    if name_matches(name, &source_name) {
+                        // Stop the source, then drop the sender: the task flushes its
+                        // last measurements and terminates (it is reaped by the JoinSet).
+                        sender.send_replace(SourceCmd::Stop);
+                        found = true;
+                        false
+                    } else {
+                        true
+                    }
+                });
+            }
+            if !found {
+                log::warn!("RemoveSource: no source named {source_name} is currently running.");
+            }
+        }
+
         ControlMessage::ModifySource(ElementCommand {
             destination,
             command: message,
         }) => match destination {
             MessageDestination::Plugin(plugin) => {
-                for s in state.source_command_senders_by_plugin.get(&plugin).unwrap() {
+                for (_, s) in state.source_command_senders_by_plugin.get(&plugin).unwrap() {
                     s.send(message.clone()).unwrap();
                 }
             }
             MessageDestination::All => {
                 for senders in state.source_command_senders_by_plugin.values() {
-                    for s in senders {
+                    for (_, s) in senders {
                         s.send(message.clone()).unwrap();
                     }
                 }
@@ -984,6 +1505,20 @@ impl ControlHandle {
         };
         self.tx.try_send(msg).unwrap()
     }
+
+    /// Stops and removes a source that was previously added with [`ControlHandle::add_source`],
+    /// without interrupting the other elements of the pipeline.
+    ///
+    /// The source flushes its last measurements and its task terminates.
+    /// Removing a source that does not exist (or that has already stopped) is not an error,
+    /// it only logs a warning.
+    pub fn remove_source(&self, plugin_name: String, source_name: String) {
+        let msg = ControlMessage::RemoveSource {
+            requested_name: source_name,
+            plugin_name,
+        };
+        self.tx.try_send(msg).unwrap()
+    }
 }
 
 pub struct ScopedControlHandle<'a> {
@@ -1066,7 +1601,7 @@ mod tests {
             Arc,
         },
         thread::sleep,
-        time::Duration,
+        time::{Duration, UNIX_EPOCH},
     };
 
     use tokio::{
@@ -1085,9 +1620,47 @@ mod tests {
     };
 
     use super::{
-        super::trigger, run_output_from_broadcast, run_source, run_transforms, OutputCmd, OutputMsg, SourceCmd,
+        super::trigger, run_output_from_broadcast, run_source, run_source_group, run_transform_stage,
+        run_transform_stage_final, run_transforms, OutputCmd, OutputMsg, SourceCmd, SourceOverloadPolicy,
     };
 
+    #[test]
+    fn source_overload_coalesce() {
+        let rt = new_rt(2);
+        let source: Box<dyn crate::pipeline::Source> = Box::new(TestSource::new());
+
+        let period = Duration::from_millis(5);
+        let tp = new_trigger(false, period, 1);
+        // A tiny channel that the source quickly fills while nobody reads it.
+        let (tx, mut rx) = mpsc::channel::<MeasurementBuffer>(1);
+        let (_cmd_tx, cmd_rx) = watch::channel(SourceCmd::SetTrigger(Some(tp)));
+
+        let policy = SourceOverloadPolicy::Coalesce { max_points: 4 };
+        rt.spawn(run_source(String::from("test_source"), source, tx, cmd_rx, policy));
+
+        // Let the source overflow the channel: the flushes after the first one fail,
+        // and the measurements are retained in the source's buffer.
+        sleep(20 * period);
+
+        // The first flush went through before the channel was full.
+        let first = rt.block_on(rx.recv()).unwrap();
+        assert_eq!(first.len(), 1);
+
+        // The retained measurements are flushed as one batch, capped at max_points
+        // (plus the polls of the rounds between the cap and the successful flush).
+        let coalesced = rt.block_on(rx.recv()).unwrap();
+        assert!(
+            coalesced.len() > 1,
+            "the retained measurements should be coalesced into one batch, got {} point(s)",
+            coalesced.len()
+        );
+        assert!(
+            coalesced.len() <= 4 + 1,
+            "the retained measurements should be capped at max_points, got {} points",
+            coalesced.len()
+        );
+    }
+
     #[test]
     fn source_triggered_by_time_normal() {
         run_source_trigger_test(false);
@@ -1148,7 +1721,13 @@ mod tests {
         });
 
         // poll the source for some time
-        rt.spawn(run_source(String::from("test_source"), Box::new(source), tx, cmd_rx));
+        rt.spawn(run_source(
+            String::from("test_source"),
+            Box::new(source),
+            tx,
+            cmd_rx,
+            SourceOverloadPolicy::default(),
+        ));
         sleep(2 * period);
 
         // pause source
@@ -1200,6 +1779,62 @@ mod tests {
         // drop the runtime, abort the tasks
     }
 
+    #[test]
+    fn source_group_coalesced_polls() {
+        let rt = new_rt(2);
+
+        // 3 sources that share one trigger, one task and one buffer
+        let sources: Vec<(String, Box<dyn crate::pipeline::Source>)> = (0..3)
+            .map(|i| (format!("test_source_{i}"), Box::new(TestSource::new()) as _))
+            .collect();
+
+        let flush_rounds = 2;
+        let tp = new_trigger(false, Duration::from_millis(10), flush_rounds);
+        let (tx, mut rx) = mpsc::channel::<MeasurementBuffer>(64);
+        let (_cmd_tx, cmd_rx) = watch::channel(SourceCmd::SetTrigger(Some(tp)));
+
+        rt.spawn(run_source_group(
+            String::from("test_group"),
+            sources,
+            tx,
+            cmd_rx,
+            SourceOverloadPolicy::default(),
+        ));
+
+        // each flush must contain the measurements of all the sources of the group
+        let measurements = rt.block_on(async move { rx.recv().await }).unwrap();
+        assert_eq!(measurements.len(), 3 * flush_rounds);
+    }
+
+    #[test]
+    fn blocking_source_polled_on_blocking_pool() {
+        let rt = new_rt(2);
+        let source: Box<dyn crate::pipeline::Source> = Box::new(TestSource::new());
+
+        let flush_rounds = 2;
+        let tp = trigger::builder::time_interval(Duration::from_millis(10))
+            .flush_rounds(flush_rounds)
+            .update_rounds(flush_rounds)
+            .blocking_poll()
+            .build()
+            .unwrap();
+
+        let (tx, mut rx) = mpsc::channel::<MeasurementBuffer>(64);
+        let (_cmd_tx, cmd_rx) = watch::channel(SourceCmd::SetTrigger(Some(tp)));
+
+        rt.spawn(run_source(
+            String::from("test_source"),
+            source,
+            tx,
+            cmd_rx,
+            SourceOverloadPolicy::default(),
+        ));
+
+        // the measurements must flow exactly like with an inline poll
+        let measurements = rt.block_on(async move { rx.recv().await }).unwrap();
+        assert_eq!(measurements.len(), flush_rounds);
+    }
+
     #[test]
     fn transform_task() {
         let rt = new_rt(2);
@@ -1291,6 +1926,7 @@ mod tests {
             Box::new(source),
             src_tx,
             src_cmd_rx,
+            SourceOverloadPolicy::default(),
         ));
         sleep(Duration::from_millis(20));
 
@@ -1317,6 +1953,85 @@ mod tests {
         sleep(Duration::from_millis(20));
     }
 
+    #[test]
+    fn parallel_transform_stages() {
+        let rt = new_rt(2);
+
+        // two transforms, each running in its own task, chained by a bounded channel
+        let transforms: Vec<Box<dyn Transform>> = vec![
+            Box::new(TestTransform {
+                id: 1,
+                expected_input_len: 2,
+                output_type: WrappedMeasurementType::U64,
+                expected_input_type: WrappedMeasurementType::U64,
+                check_input_type: Arc::new(AtomicBool::new(true)),
+            }),
+            Box::new(TestTransform {
+                id: 2,
+                expected_input_len: 2,
+                output_type: WrappedMeasurementType::F64,
+                expected_input_type: WrappedMeasurementType::U64,
+                check_input_type: Arc::new(AtomicBool::new(true)),
+            }),
+        ];
+        let mut transforms: Vec<ConfiguredTransform> = transforms
+            .into_iter()
+            .map(|t| ConfiguredTransform {
+                transform: t,
+                name: String::from("test_transform"),
+                plugin_name: String::from(""),
+            })
+            .collect();
+        let last = transforms.pop().unwrap();
+        let first = transforms.pop().unwrap();
+
+        let (in_tx, in_rx) = mpsc::channel::<MeasurementBuffer>(8);
+        let (mid_tx, mid_rx) = mpsc::channel::<MeasurementBuffer>(8);
+        let (out_tx, mut out_rx) = broadcast::channel::<OutputMsg>(8);
+        let active_flags = Arc::new(AtomicU64::new(u64::MAX));
+
+        rt.spawn(run_transform_stage(0, first, in_rx, mid_tx, active_flags.clone()));
+        rt.spawn(run_transform_stage_final(1, last, mid_rx, out_tx, active_flags));
+
+        rt.block_on(async move {
+            // each input buffer gets a distinct timestamp to check the ordering of the outputs
+            let timestamps: Vec<Timestamp> =
+                (0..3).map(|i| Timestamp::from(UNIX_EPOCH + Duration::from_secs(i))).collect();
+            for &ts in &timestamps {
+                let mut buf = MeasurementBuffer::new();
+                for _ in 0..2 {
+                    buf.push(MeasurementPoint::new_untyped(
+                        ts,
+                        RawMetricId(1),
+                        Resource::LocalMachine,
+                        ResourceConsumer::LocalMachine,
+                        WrappedMeasurementValue::U64(0),
+                    ));
+                }
+                in_tx.send(buf).await.unwrap();
+            }
+
+            // the buffers must traverse both stages and come out in sending order
+            for &ts in &timestamps {
+                match out_rx.recv().await.unwrap() {
+                    OutputMsg::WriteMeasurements(measurements) => {
+                        assert_eq!(measurements.len(), 2);
+                        for m in measurements.iter() {
+                            assert!(m.timestamp == ts, "buffers must be delivered in order");
+                            assert_eq!(m.value.measurement_type(), WrappedMeasurementType::F64);
+                            let int_val = match m.value {
+                                WrappedMeasurementValue::F64(f) => f as u32,
+                                WrappedMeasurementValue::U64(u) => u as u32,
+                            };
+                            assert_eq!(int_val, 2, "the last stage must be applied last");
+                        }
+                    }
+                    _ => panic!("unexpected output message"),
+                }
+            }
+        });
+    }
+
     #[test]
     fn output_task() {
         let rt = new_rt(3);
@@ -1339,7 +2054,7 @@ mod tests {
         });
         let (out_cmd_tx, out_cmd_rx) = watch::channel(OutputCmd::Run);
         let out_ctx = OutputContext {
-            metrics: MetricRegistry::new(),
+            metrics: Arc::new(MetricRegistry::new()),
         };
 
         // start tasks
@@ -1351,7 +2066,13 @@ mod tests {
             out_ctx,
         ));
         rt.spawn(run_transforms(transforms, trans_rx, trans_tx, active_flags));
-        rt.spawn(run_source(String::from("test_source"), source, src_tx, src_cmd_rx));
+        rt.spawn(run_source(
+            String::from("test_source"),
+            source,
+            src_tx,
+            src_cmd_rx,
+            SourceOverloadPolicy::default(),
+        ));
 
         // check the output
         sleep(Duration::from_millis(20));
@@ -40,3 +40,33 @@ where
     })
     .await
 }
+
+/// Like [`spawn_blocking_with_output`], but generic over the two borrowed arguments.
+///
+/// Used to poll blocking sources (see
+/// [`TimeTriggerBuilder::blocking_poll`](super::trigger::builder::TimeTriggerBuilder::blocking_poll))
+/// on the blocking thread pool without moving the source and its buffer out of the task.
+pub async fn spawn_blocking_with<A, B, F, R>(a: &mut A, b: &mut B, func: F) -> Result<R, tokio::task::JoinError>
+where
+    // Only the borrows are scoped: the pointee types themselves must be 'static,
+    // like the `dyn Output` erased by `spawn_blocking_with_output`.
+    A: ?Sized + Send + 'static,
+    B: ?Sized + Send + 'static,
+    F: FnOnce(&mut A, &mut B) -> R + Send + 'static,
+    R: Send + 'static,
+{
+    struct SendPtr<T: ?Sized>(*mut T);
+    unsafe impl<T: ?Sized> Send for SendPtr<T> {}
+    let a_ptr = SendPtr(a as *mut A);
+    let b_ptr = SendPtr(b as *mut B);
+    let rt = tokio::runtime::Handle::current();
+    rt.spawn_blocking(move || {
+        // SAFETY: we wait for the task to finish, and tokio catches the panics,
+        // therefore the pointers remain valid during the entire call to `func`.
+        let (a_ptr, b_ptr) = (a_ptr, b_ptr); // We move the wrappers, not the pointers
+        let a = unsafe { &mut *a_ptr.0 };
+        let b = unsafe { &mut *b_ptr.0 };
+        func(a, b)
+    })
+    .await
+}
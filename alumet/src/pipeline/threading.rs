@@ -18,3 +18,40 @@ pub fn increase_thread_priority() -> std::io::Result<()> {
     #[cfg(not(target_os = "linux"))]
     Err(std::io::Error::new(std::io::ErrorKind::Unsupported, "cannot increase the thread priority on this platform"))
 }
+
+/// Pins the current thread to the given set of CPU cores.
+///
+/// This prevents the scheduler from migrating the thread to another core,
+/// which reduces the jitter of time-sensitive polling. To also keep other
+/// processes away from these cores, reserve them at boot time with the
+/// `isolcpus` kernel parameter (or a cpuset) and pass the isolated core ids here.
+pub fn pin_current_thread(cpus: &[u32]) -> std::io::Result<()> {
+    if cpus.is_empty() {
+        return Err(std::io::Error::new(
+            std::io::ErrorKind::InvalidInput,
+            "the set of cpus to pin the thread to must not be empty",
+        ));
+    }
+    #[cfg(target_os = "linux")]
+    {
+        let mut cpuset: libc::cpu_set_t = unsafe { std::mem::zeroed() };
+        unsafe { libc::CPU_ZERO(&mut cpuset) };
+        for cpu in cpus {
+            if *cpu >= libc::CPU_SETSIZE as u32 {
+                return Err(std::io::Error::new(
+                    std::io::ErrorKind::InvalidInput,
+                    format!("invalid cpu id: {cpu}"),
+                ));
+            }
+            unsafe { libc::CPU_SET(*cpu as usize, &mut cpuset) };
+        }
+        let res = unsafe { libc::sched_setaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &cpuset) };
+        if res < 0 {
+            Err(std::io::Error::last_os_error())
+        } else {
+            Ok(())
+        }
+    }
+    #[cfg(not(target_os = "linux"))]
+    Err(std::io::Error::new(std::io::ErrorKind::Unsupported, "cannot set the thread affinity on this platform"))
+}
@@ -23,6 +23,7 @@ pub struct TriggerSpec {
     mechanism: TriggerMechanismSpec,
     interruptible: bool,
     pub(crate) realtime_priority: bool,
+    pub(crate) coalesce: bool,
     config: TriggerConfig,
 }
 
@@ -38,6 +39,8 @@ pub(crate) struct TriggerConfig {
     /// Numbers of polling operations to do before flushing the measurements.
     ///
     /// Flushing more often increases the pressure on the memory allocator.
+    /// In adaptive flush mode (see [`adaptive_flush`](Self::adaptive_flush)),
+    /// this is the *current* cadence, adjusted after each flush.
     pub flush_rounds: usize,
 
     /// Number of polling operations to do before updating the command.
@@ -46,6 +49,51 @@ pub(crate) struct TriggerConfig {
     /// but decreases the time it takes for a [source command](super::runtime::SourceCmd)
     /// to be applied.
     pub update_rounds: usize,
+
+    /// If set, `flush_rounds` is adjusted at runtime to target a flush size in points.
+    /// See [`builder::TimeTriggerBuilder::flush_target`].
+    pub adaptive_flush: Option<AdaptiveFlush>,
+
+    /// Timestamp the polls with the coarse clock instead of the precise one.
+    /// See [`builder::TimeTriggerBuilder::coarse_timestamps`].
+    pub coarse_timestamps: bool,
+
+    /// Run each poll on the blocking thread pool instead of the async worker.
+    /// See [`builder::TimeTriggerBuilder::blocking_poll`].
+    pub blocking_poll: bool,
+}
+
+/// Parameters of the adaptive flush mode.
+///
+/// See [`builder::TimeTriggerBuilder::flush_target`].
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) struct AdaptiveFlush {
+    /// Desired number of measurement points per flush.
+    pub target_points: usize,
+    /// Hard latency bound: never wait more than this many rounds before flushing.
+    pub max_rounds: usize,
+}
+
+impl TriggerConfig {
+    /// Adjusts `flush_rounds` after a flush of `flushed_points` points, in adaptive flush mode.
+    ///
+    /// The new cadence targets `target_points` per flush, based on the number of points
+    /// per round observed since the previous flush, and never exceeds the latency bound
+    /// `max_rounds`. Does nothing if the adaptive mode is disabled.
+    pub fn adapt_flush_rounds(&mut self, flushed_points: usize) {
+        if let Some(adaptive) = &self.adaptive_flush {
+            let points_per_round = (flushed_points / self.flush_rounds).max(1);
+            let new_rounds = (adaptive.target_points / points_per_round).clamp(1, adaptive.max_rounds);
+            if new_rounds != self.flush_rounds {
+                log::trace!(
+                    "adaptive flush: {} points per round, flush_rounds {} -> {new_rounds}",
+                    points_per_round,
+                    self.flush_rounds
+                );
+                self.flush_rounds = new_rounds;
+            }
+        }
+    }
 }
 
 /// Constraints that can be applied to a [`TriggerSpec`] after its construction.
@@ -60,7 +108,7 @@ pub mod builder {
     use core::fmt;
     use std::time::{Duration, Instant};
 
-    use super::{TriggerConfig, TriggerMechanismSpec, TriggerSpec};
+    use super::{AdaptiveFlush, TriggerConfig, TriggerMechanismSpec, TriggerSpec};
 
     /// Returns a builder for a source trigger that polls the source at regular intervals.
     ///
@@ -94,6 +142,7 @@ pub mod builder {
         config: TriggerConfig,
         interruptible: bool,
         realtime_priority: bool,
+        coalesce: bool,
     }
 
     #[derive(Debug)]
@@ -121,9 +170,13 @@ pub mod builder {
                 config: TriggerConfig {
                     flush_rounds: 1,
                     update_rounds: 1,
+                    adaptive_flush: None,
+                    coarse_timestamps: false,
+                    blocking_poll: false,
                 },
                 interruptible: false,
                 realtime_priority: false,
+                coalesce: false,
             }
         }
 
@@ -156,6 +209,31 @@ pub mod builder {
             self
         }
 
+        /// Adaptive flush: target approximately `target_points` measurement points per flush,
+        /// but never wait more than `max_flush_interval` between two flushes.
+        ///
+        /// Unlike [`flush_rounds`](Self::flush_rounds) and [`flush_interval`](Self::flush_interval),
+        /// which fix the cadence at build time, the effective number of rounds between flushes
+        /// is adjusted at runtime from the observed number of points per poll. If the source
+        /// suddenly produces many more (or fewer) points per poll, the flushed batches keep
+        /// roughly the same size: memory use stays flat and the traffic on the measurement
+        /// channel stays amortized, whatever the source fan-out.
+        pub fn flush_target(mut self, target_points: usize, max_flush_interval: Duration) -> Self {
+            if self.poll_interval.is_zero() {
+                return self; // don't modify anything, build() will fail
+            }
+
+            let max_rounds = ((max_flush_interval.as_nanos() / self.poll_interval.as_nanos()) as usize).max(1);
+            self.config.adaptive_flush = Some(AdaptiveFlush {
+                target_points,
+                max_rounds,
+            });
+            // Start by flushing on the first round: the first flush measures the
+            // points-per-round of the source and sets the real cadence.
+            self.config.flush_rounds = 1;
+            self
+        }
+
         /// Update the source command after, at most, the given duration.
         pub fn update_interval(mut self, update_interval: Duration) -> Self {
             if self.poll_interval.is_zero() {
@@ -187,11 +265,68 @@ pub mod builder {
             self
         }
 
+        /// Timestamps the measurements with a coarse, cached clock instead of the precise one.
+        ///
+        /// The coarse clock (see [`Timestamp::now_coarse`](crate::measurement::Timestamp::now_coarse))
+        /// is refreshed by the kernel on each scheduler tick and read without a system call,
+        /// which makes it much cheaper when many sources are polled at high frequency.
+        /// Sources polled in the same tick share the same timestamp value, so the
+        /// timestamps are aligned, which helps downstream batching and compression.
+        ///
+        /// Do not enable this for sources that need sub-millisecond timestamp accuracy
+        /// (such as [`RealtimePriority`](crate::pipeline::SourceType::RealtimePriority)
+        /// sources used for fine-grained profiling): the granularity of the coarse clock
+        /// is the kernel tick, usually 1 to 4 ms. The precise clock remains the default.
+        pub fn coarse_timestamps(mut self) -> Self {
+            self.config.coarse_timestamps = true;
+            self
+        }
+
+        /// Allows the pipeline to coalesce this source with other sources of the same plugin
+        /// that have a compatible trigger (same poll interval, same flush and update settings).
+        ///
+        /// Coalesced sources share one timer and one task: on each tick, they are polled
+        /// back-to-back into a shared buffer, which is flushed downstream as a single batch.
+        /// With many sources (e.g. one per cgroup), this replaces N timer wakeups, N task
+        /// switches and N small buffer sends per period by a single one.
+        ///
+        /// Do not enable this for latency-critical sources: a slow source of the group
+        /// delays the polling of the others, and pipeline commands apply to the whole group.
+        pub fn coalesce(mut self) -> Self {
+            self.coalesce = true;
+            self
+        }
+
+        /// Signals that the source's `poll` does blocking I/O and must not run
+        /// directly on an async worker of the runtime.
+        ///
+        /// The pipeline shares a small set of async workers between all the sources:
+        /// a `poll` that blocks (filesystem reads, device driver calls such as NVML)
+        /// stalls its worker and adds latency to the unrelated sources that share it.
+        /// With this option, the poll is offloaded to the blocking thread pool of the
+        /// runtime, which grows on demand, so slow sources overlap their I/O and the
+        /// cooperative workers stay responsive even with many sources.
+        ///
+        /// The offload costs a thread handoff per poll: prefer making the source
+        /// non-blocking when possible, and reserve this for sources that wrap
+        /// inherently blocking APIs.
+        pub fn blocking_poll(mut self) -> Self {
+            self.config.blocking_poll = true;
+            self
+        }
+
         /// Builds the trigger.
         pub fn build(mut self) -> Result<TriggerSpec, Error> {
             if self.poll_interval.is_zero() {
                 return Err(Error::InvalidConfig(String::from("poll_interval must be non-zero")));
             }
+            if let Some(adaptive) = &self.config.adaptive_flush {
+                if adaptive.target_points == 0 {
+                    return Err(Error::InvalidConfig(String::from(
+                        "flush_target points must be non-zero",
+                    )));
+                }
+            }
             // automatically enable `realtime_priority` in some cases
             if self.poll_interval <= Duration::from_millis(3) {
                 self.realtime_priority = true;
@@ -201,6 +336,7 @@ pub mod builder {
                 mechanism: TriggerMechanismSpec::TimeInterval(self.start, self.poll_interval),
                 interruptible: self.interruptible,
                 realtime_priority: self.realtime_priority,
+                coalesce: self.coalesce,
                 config: self.config,
             })
         }
@@ -222,6 +358,31 @@ impl TriggerSpec {
         builder::time_interval(poll_interval)
     }
 
+    /// Returns true if a source with this trigger can share a timer and a task
+    /// with a source that has the trigger `other`.
+    ///
+    /// Both triggers must have requested coalescing (see [`builder::TimeTriggerBuilder::coalesce`]),
+    /// and must be identical except for their starting point.
+    pub(crate) fn can_coalesce_with(&self, other: &TriggerSpec) -> bool {
+        self.coalesce
+            && other.coalesce
+            && self.interruptible == other.interruptible
+            && self.realtime_priority == other.realtime_priority
+            && self.config.flush_rounds == other.config.flush_rounds
+            && self.config.update_rounds == other.config.update_rounds
+            && self.config.adaptive_flush == other.config.adaptive_flush
+            && self.config.coarse_timestamps == other.config.coarse_timestamps
+            && self.config.blocking_poll == other.config.blocking_poll
+            && match (&self.mechanism, &other.mechanism) {
+                // the starting Instant is ignored: triggers built at slightly different times can be grouped
+                (
+                    TriggerMechanismSpec::TimeInterval(_, poll_interval),
+                    TriggerMechanismSpec::TimeInterval(_, other_poll_interval),
+                ) => poll_interval == other_poll_interval,
+                _ => false,
+            }
+    }
+
     /// Adjusts the trigger specification to respect the given constraints.
     ///
     /// # Constraints
@@ -408,7 +569,7 @@ impl fmt::Debug for TriggerMechanism {
 mod tests {
     use std::time::Duration;
 
-    use super::{builder, TriggerConstraints, TriggerMechanismSpec};
+    use super::{builder, AdaptiveFlush, TriggerConstraints, TriggerMechanismSpec};
 
     #[test]
     fn trigger_auto_config() {
@@ -454,6 +615,41 @@ mod tests {
         }
     }
 
+    #[test]
+    fn adaptive_flush() {
+        let trigger = builder::time_interval(Duration::from_millis(10))
+            .flush_target(100, Duration::from_secs(1)) // latency bound: 100 rounds
+            .build()
+            .unwrap();
+        let mut config = trigger.config;
+        assert_eq!(config.flush_rounds, 1); // first flush measures the source
+        assert_eq!(
+            config.adaptive_flush,
+            Some(AdaptiveFlush {
+                target_points: 100,
+                max_rounds: 100
+            })
+        );
+
+        // 4 points per round => flush every 25 rounds to reach 100 points
+        config.adapt_flush_rounds(4);
+        assert_eq!(config.flush_rounds, 25);
+
+        // fan-out explodes: 25 rounds * 200 points per round => back to 1 round per flush
+        config.adapt_flush_rounds(25 * 200);
+        assert_eq!(config.flush_rounds, 1);
+
+        // fan-out collapses: the latency bound caps the cadence
+        config.adapt_flush_rounds(0);
+        assert_eq!(config.flush_rounds, 100);
+
+        // target_points = 0 is rejected
+        assert!(builder::time_interval(Duration::from_millis(10))
+            .flush_target(0, Duration::from_secs(1))
+            .build()
+            .is_err());
+    }
+
     #[test]
     fn trigger_constraints() {
         let constraints = TriggerConstraints {
@@ -29,6 +29,12 @@ struct DylibPlugin {
     instance: *mut c_void,
 }
 
+// The plugin instance is an opaque pointer to a structure allocated by the external plugin.
+// Like FfiSource & co (see the ffi module), it is only ever used by one thread at a time,
+// and the external code cannot assume anything about the thread that calls it anyway
+// (the agent may start the plugin from another thread, see `AgentBuilder::parallel_startup`).
+unsafe impl Send for DylibPlugin {}
+
 impl Plugin for DylibPlugin {
     fn name(&self) -> &str {
         &self.name
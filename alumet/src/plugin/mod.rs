@@ -85,6 +85,7 @@
 //!
 use std::future::Future;
 use std::marker::PhantomData;
+use std::sync::{Mutex, MutexGuard};
 
 use tokio_util::sync::CancellationToken;
 
@@ -104,6 +105,7 @@ pub mod dynload;
 
 pub mod event;
 pub mod rust;
+pub mod stats;
 pub mod util;
 pub(crate) mod version;
 
@@ -114,7 +116,10 @@ pub struct PluginMetadata {
     /// Version of the plugin, should follow semantic versioning (of the form `x.y.z`).
     pub version: String,
     /// Function that initializes the plugin.
-    pub init: Box<dyn FnOnce(ConfigTable) -> anyhow::Result<Box<dyn Plugin>>>,
+    ///
+    /// It must be `Send` because the agent can initialize the plugins concurrently,
+    /// see [`AgentBuilder::parallel_startup`](crate::agent::AgentBuilder::parallel_startup).
+    pub init: Box<dyn FnOnce(ConfigTable) -> anyhow::Result<Box<dyn Plugin>> + Send>,
     /// Function that returns a default configuration for the plugin, or None
     /// if the plugin has no configurable option.
     ///
@@ -174,7 +179,10 @@ pub struct ConfigTable(pub toml::Table);
 ///
 /// If you are writing a plugin in Rust, implement [`AlumetPlugin`] instead.
 /// If you are writing a plugin in C, you need to define the right symbols in your shared library.
-pub trait Plugin {
+///
+/// Plugins must be [`Send`], because the agent can initialize and start them from another
+/// thread, see [`AgentBuilder::parallel_startup`](crate::agent::AgentBuilder::parallel_startup).
+pub trait Plugin: Send {
     /// The name of the plugin. It must be unique: two plugins cannot have the same name.
     fn name(&self) -> &str;
 
@@ -216,7 +224,7 @@ pub trait Plugin {
 /// ## Note for applications
 /// You should not create `AlumetStart` manually, build an [`Agent`](crate::agent::Agent) instead.
 pub struct AlumetStart<'a> {
-    pub(crate) pipeline_builder: &'a mut PipelineBuilder,
+    pub(crate) pipeline_builder: &'a Mutex<PipelineBuilder>,
     pub(crate) current_plugin_name: String,
 }
 
@@ -226,7 +234,17 @@ impl<'a> AlumetStart<'a> {
         &self.current_plugin_name
     }
 
-    pub fn new(pipeline_builder: &'a mut PipelineBuilder, plugin_name: String) -> AlumetStart<'a> {
+    /// Locks the pipeline builder for one registration operation.
+    ///
+    /// The builder is shared behind a mutex so that multiple plugins can be started
+    /// concurrently, see [`AgentBuilder::parallel_startup`](crate::agent::AgentBuilder::parallel_startup).
+    fn builder(&self) -> MutexGuard<'a, PipelineBuilder> {
+        self.pipeline_builder
+            .lock()
+            .expect("pipeline builder mutex should not be poisoned")
+    }
+
+    pub fn new(pipeline_builder: &'a Mutex<PipelineBuilder>, plugin_name: String) -> AlumetStart<'a> {
         Self {
             pipeline_builder,
             current_plugin_name: plugin_name,
@@ -247,7 +265,7 @@ impl<'a> AlumetStart<'a> {
             value_type: T::wrapped_type(),
             unit: unit.into(),
         };
-        let untyped_id = self.pipeline_builder.metrics.register(m)?;
+        let untyped_id = self.builder().metrics.register(m)?;
         Ok(TypedMetricId(untyped_id, PhantomData))
     }
 
@@ -270,17 +288,15 @@ impl<'a> AlumetStart<'a> {
             value_type,
             unit: unit.into(),
         };
-        self.pipeline_builder.metrics.register(m)
+        self.builder().metrics.register(m)
     }
 
     /// Adds a measurement source to the Alumet pipeline.
     pub fn add_source(&mut self, source: Box<dyn Source>, trigger: TriggerSpec) {
         let plugin = self.current_plugin_name().to_owned();
-        let name = self
-            .pipeline_builder
-            .namegen
-            .deduplicate(format!("{plugin}/source"), true);
-        self.pipeline_builder.sources.push(ManagedSourceBuilder {
+        let mut builder = self.builder();
+        let name = builder.namegen.deduplicate(format!("{plugin}/source"), true);
+        builder.sources.push(ManagedSourceBuilder {
             name,
             plugin,
             trigger,
@@ -296,17 +312,15 @@ impl<'a> AlumetStart<'a> {
     ///
     /// The downside is a more complicated code.
     /// In general, you should prefer to use [`add_source`](Self::add_source) if possible.
-    pub fn add_source_builder<F: FnOnce(&PendingPipelineContext) -> Box<dyn Source> + 'static>(
+    pub fn add_source_builder<F: FnOnce(&PendingPipelineContext) -> Box<dyn Source> + Send + 'static>(
         &mut self,
         trigger: TriggerSpec,
         source_builder: F,
     ) {
         let plugin = self.current_plugin_name().to_owned();
-        let name = self
-            .pipeline_builder
-            .namegen
-            .deduplicate(format!("{plugin}/source"), true);
-        self.pipeline_builder.sources.push(ManagedSourceBuilder {
+        let mut builder = self.builder();
+        let name = builder.namegen.deduplicate(format!("{plugin}/source"), true);
+        builder.sources.push(ManagedSourceBuilder {
             name,
             plugin,
             trigger,
@@ -359,15 +373,15 @@ impl<'a> AlumetStart<'a> {
     /// ```
     pub fn add_autonomous_source<F, S>(&mut self, source_builder: F)
     where
-        F: FnOnce(&PendingPipelineContext, CancellationToken, tokio::sync::mpsc::Sender<MeasurementBuffer>) -> S + 'static,
+        F: FnOnce(&PendingPipelineContext, CancellationToken, tokio::sync::mpsc::Sender<MeasurementBuffer>) -> S
+            + Send
+            + 'static,
         S: Future<Output = anyhow::Result<()>> + Send + 'static,
     {
         let plugin = self.current_plugin_name().to_owned();
-        let name = self
-            .pipeline_builder
-            .namegen
-            .deduplicate(format!("{plugin}/autonomous_source"), true);
-        self.pipeline_builder.autonomous_sources.push(AutonomousSourceBuilder {
+        let mut builder = self.builder();
+        let name = builder.namegen.deduplicate(format!("{plugin}/autonomous_source"), true);
+        builder.autonomous_sources.push(AutonomousSourceBuilder {
             name,
             plugin,
             build: Box::new(|p: &_, cancel, tx| Box::pin(source_builder(p, cancel, tx))),
@@ -377,11 +391,9 @@ impl<'a> AlumetStart<'a> {
     /// Adds a transform step to the Alumet pipeline.
     pub fn add_transform(&mut self, transform: Box<dyn Transform>) {
         let plugin = self.current_plugin_name().to_owned();
-        let name = self
-            .pipeline_builder
-            .namegen
-            .deduplicate(format!("{plugin}/transform"), true);
-        self.pipeline_builder.transforms.push(TransformBuilder {
+        let mut builder = self.builder();
+        let name = builder.namegen.deduplicate(format!("{plugin}/transform"), true);
+        builder.transforms.push(TransformBuilder {
             name,
             plugin,
             build: Box::new(|_| transform),
@@ -391,11 +403,9 @@ impl<'a> AlumetStart<'a> {
     /// Adds an output to the Alumet pipeline.
     pub fn add_output(&mut self, output: Box<dyn Output>) {
         let plugin = self.current_plugin_name().to_owned();
-        let name = self
-            .pipeline_builder
-            .namegen
-            .deduplicate(format!("{plugin}/output"), true);
-        self.pipeline_builder.outputs.push(OutputBuilder {
+        let mut builder = self.builder();
+        let name = builder.namegen.deduplicate(format!("{plugin}/output"), true);
+        builder.outputs.push(OutputBuilder {
             name,
             plugin,
             build: Box::new(|_| Ok(output)),
@@ -410,16 +420,16 @@ impl<'a> AlumetStart<'a> {
     /// in order to use an async library.
     ///
     /// In general, you should prefer to use [`add_output`](Self::add_output) if possible.
-    pub fn add_output_builder<F: FnOnce(&PendingPipelineContext) -> anyhow::Result<Box<dyn Output>> + 'static>(
+    pub fn add_output_builder<
+        F: FnOnce(&PendingPipelineContext) -> anyhow::Result<Box<dyn Output>> + Send + 'static,
+    >(
         &mut self,
         output_builder: F,
     ) {
         let plugin = self.current_plugin_name().to_owned();
-        let name = self
-            .pipeline_builder
-            .namegen
-            .deduplicate(format!("{plugin}/output"), true);
-        self.pipeline_builder.outputs.push(OutputBuilder {
+        let mut builder = self.builder();
+        let name = builder.namegen.deduplicate(format!("{plugin}/output"), true);
+        builder.outputs.push(OutputBuilder {
             name,
             plugin,
             build: Box::new(output_builder),
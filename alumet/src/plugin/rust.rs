@@ -15,8 +15,11 @@ use super::ConfigTable;
 ///
 /// Implement this trait to define your plugin.
 /// See the [plugin module documentation](super#static-plugins).
-pub trait AlumetPlugin {
+pub trait AlumetPlugin: Send {
     // Note: add `where Self: Sized` to make this trait "object safe", if necessary in the future.
+    //
+    // The `Send` bound is required because the agent can initialize and start the plugins
+    // from another thread, see `AgentBuilder::parallel_startup`.
 
     /// The name of the plugin. It must be unique: two plugins cannot have the same name.
     fn name() -> &'static str;
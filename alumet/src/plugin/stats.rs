@@ -0,0 +1,170 @@
+//! Built-in plugin that measures the measurement pipeline itself.
+//!
+//! It registers a low-frequency source that samples the global counters of
+//! [`pipeline::stats`](crate::pipeline::stats) and publishes them as regular
+//! Alumet metrics, so that the usual outputs (and alerting on top of them) can
+//! detect pipeline saturation before measurements get lost.
+//!
+//! Add [`SelfStatsPlugin`] to the agent's plugin list to enable it.
+
+use std::time::Duration;
+
+use crate::measurement::{MeasurementAccumulator, MeasurementPoint, Timestamp};
+use crate::metrics::TypedMetricId;
+use crate::pipeline::trigger::TriggerSpec;
+use crate::pipeline::{stats, PollError, Source};
+use crate::resources::{Resource, ResourceConsumer};
+use crate::units::{PrefixedUnit, Unit};
+
+use super::rust::AlumetPlugin;
+use super::{AlumetStart, ConfigTable};
+
+/// Default interval between two samples of the pipeline counters.
+const DEFAULT_POLL_INTERVAL_SECS: i64 = 5;
+
+/// Built-in plugin that publishes the pipeline self-instrumentation counters.
+pub struct SelfStatsPlugin {
+    poll_interval: Duration,
+}
+
+impl AlumetPlugin for SelfStatsPlugin {
+    fn name() -> &'static str {
+        "pipeline-stats"
+    }
+
+    fn version() -> &'static str {
+        env!("CARGO_PKG_VERSION")
+    }
+
+    fn default_config() -> anyhow::Result<Option<ConfigTable>> {
+        let mut table = toml::Table::new();
+        table.insert(
+            String::from("poll_interval_secs"),
+            toml::Value::Integer(DEFAULT_POLL_INTERVAL_SECS),
+        );
+        Ok(Some(ConfigTable(table)))
+    }
+
+    fn init(config: ConfigTable) -> anyhow::Result<Box<Self>> {
+        // The config is read manually: the alumet crate does not depend on serde_derive.
+        let poll_interval_secs = match config.0.get("poll_interval_secs") {
+            Some(toml::Value::Integer(secs)) if *secs > 0 => *secs,
+            Some(bad_value) => anyhow::bail!("poll_interval_secs must be a positive integer, not {bad_value}"),
+            None => DEFAULT_POLL_INTERVAL_SECS,
+        };
+        Ok(Box::new(SelfStatsPlugin {
+            poll_interval: Duration::from_secs(poll_interval_secs as u64),
+        }))
+    }
+
+    fn start(&mut self, alumet: &mut AlumetStart) -> anyhow::Result<()> {
+        let nanoseconds = PrefixedUnit::nano(Unit::Second);
+        let metrics = StatsMetrics {
+            poll_count: alumet.create_metric(
+                "alumet_source_polls",
+                Unit::Unity,
+                "number of source polls since the previous sample",
+            )?,
+            poll_nanos_total: alumet.create_metric(
+                "alumet_source_poll_time_total",
+                nanoseconds.clone(),
+                "total time spent in Source::poll since the previous sample",
+            )?,
+            poll_nanos_max: alumet.create_metric(
+                "alumet_source_poll_time_max",
+                nanoseconds.clone(),
+                "worst Source::poll duration since the previous sample",
+            )?,
+            transform_nanos_total: alumet.create_metric(
+                "alumet_transform_time_total",
+                nanoseconds.clone(),
+                "total time spent applying the transforms since the previous sample",
+            )?,
+            write_count: alumet.create_metric(
+                "alumet_output_writes",
+                Unit::Unity,
+                "number of output writes since the previous sample",
+            )?,
+            write_nanos_total: alumet.create_metric(
+                "alumet_output_write_time_total",
+                nanoseconds.clone(),
+                "total time spent in Output::write since the previous sample",
+            )?,
+            write_nanos_max: alumet.create_metric(
+                "alumet_output_write_time_max",
+                nanoseconds,
+                "worst Output::write duration since the previous sample",
+            )?,
+            flushed_points: alumet.create_metric(
+                "alumet_flushed_points",
+                Unit::Unity,
+                "number of measurement points flushed by the sources since the previous sample",
+            )?,
+            source_channel_occupancy_max: alumet.create_metric(
+                "alumet_source_channel_occupancy_max",
+                Unit::Unity,
+                "worst observed occupancy of the source channel since the previous sample",
+            )?,
+            output_lagged_messages: alumet.create_metric(
+                "alumet_output_lagged_messages",
+                Unit::Unity,
+                "number of broadcast messages missed by lagging outputs since the previous sample",
+            )?,
+        };
+        alumet.add_source(
+            Box::new(SelfStatsSource { metrics }),
+            TriggerSpec::at_interval(self.poll_interval),
+        );
+        Ok(())
+    }
+
+    fn stop(&mut self) -> anyhow::Result<()> {
+        Ok(())
+    }
+}
+
+/// Ids of the self-instrumentation metrics.
+struct StatsMetrics {
+    poll_count: TypedMetricId<u64>,
+    poll_nanos_total: TypedMetricId<u64>,
+    poll_nanos_max: TypedMetricId<u64>,
+    transform_nanos_total: TypedMetricId<u64>,
+    write_count: TypedMetricId<u64>,
+    write_nanos_total: TypedMetricId<u64>,
+    write_nanos_max: TypedMetricId<u64>,
+    flushed_points: TypedMetricId<u64>,
+    source_channel_occupancy_max: TypedMetricId<u64>,
+    output_lagged_messages: TypedMetricId<u64>,
+}
+
+/// Source that samples (and resets) the pipeline counters.
+struct SelfStatsSource {
+    metrics: StatsMetrics,
+}
+
+impl Source for SelfStatsSource {
+    fn poll(&mut self, measurements: &mut MeasurementAccumulator, timestamp: Timestamp) -> Result<(), PollError> {
+        let snapshot = stats::snapshot();
+        let m = &self.metrics;
+        let mut push = |metric: TypedMetricId<u64>, value: u64| {
+            measurements.push(MeasurementPoint::new(
+                timestamp,
+                metric,
+                Resource::LocalMachine,
+                ResourceConsumer::LocalMachine,
+                value,
+            ));
+        };
+        push(m.poll_count, snapshot.poll_count);
+        push(m.poll_nanos_total, snapshot.poll_nanos_total);
+        push(m.poll_nanos_max, snapshot.poll_nanos_max);
+        push(m.transform_nanos_total, snapshot.transform_nanos_total);
+        push(m.write_count, snapshot.write_count);
+        push(m.write_nanos_total, snapshot.write_nanos_total);
+        push(m.write_nanos_max, snapshot.write_nanos_max);
+        push(m.flushed_points, snapshot.flushed_points);
+        push(m.source_channel_occupancy_max, snapshot.source_channel_occupancy_max);
+        push(m.output_lagged_messages, snapshot.output_lagged_messages);
+        Ok(())
+    }
+}
@@ -41,7 +41,7 @@ pub type StrCow = Cow<'static, str>;
 
 /// Hardware or software entity for which metrics can be gathered.
 #[non_exhaustive]
-#[derive(Debug, Clone, PartialEq, Eq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 #[repr(C)]
 pub enum Resource {
     /// The whole local machine, for instance the whole physical server.
@@ -60,7 +60,7 @@ pub enum Resource {
 
 /// Consumer of a [`resource`](Resource).
 #[non_exhaustive]
-#[derive(Debug, Clone, PartialEq, Eq)]
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
 #[repr(C)]
 pub enum ResourceConsumer {
     /// The whole local machine.
@@ -105,6 +105,20 @@ impl Resource {
         }
     }
 
+    /// Returns the id of the resource as a borrowed string, if it is stored as one.
+    ///
+    /// Numeric ids (such as the id of a [`Resource::CpuPackage`]) are not stored as strings,
+    /// hence `None` is returned for them: use [`id_display`](Self::id_display) or
+    /// [`id_string`](Self::id_string) to format them.
+    pub fn id_str(&self) -> Option<&str> {
+        match self {
+            Resource::LocalMachine => Some(""),
+            Resource::Gpu { bus_id } => Some(bus_id),
+            Resource::Custom { kind: _, id } => Some(id),
+            _ => None,
+        }
+    }
+
     pub fn id_display(&self) -> impl fmt::Display + '_ {
         match self {
             Resource::LocalMachine => LazyDisplayable::Str(""),
@@ -174,6 +188,20 @@ impl ResourceConsumer {
         }
     }
 
+    /// Returns the id of the consumer as a borrowed string, if it is stored as one.
+    ///
+    /// Numeric ids (such as the pid of a [`ResourceConsumer::Process`]) are not stored as strings,
+    /// hence `None` is returned for them: use [`id_display`](Self::id_display) or
+    /// [`id_string`](Self::id_string) to format them.
+    pub fn id_str(&self) -> Option<&str> {
+        match self {
+            ResourceConsumer::LocalMachine => Some(""),
+            ResourceConsumer::ControlGroup { path } => Some(path),
+            ResourceConsumer::Custom { kind: _, id } => Some(id),
+            _ => None,
+        }
+    }
+
     pub fn id_display(&self) -> impl fmt::Display + '_ {
         match self {
             ResourceConsumer::LocalMachine => LazyDisplayable::Str(""),
@@ -14,18 +14,20 @@ fn test_plugin_lifecycle() {
     // Each plugin will register 2 metrics, 1 source, 1 transform, 1 output.
     let mut plugins: Vec<Box<TestPlugin>> = vec![TestPlugin::init("plugin1", 98), TestPlugin::init("plugin2", 1000)];
 
-    let mut pipeline_builder = PipelineBuilder::new();
+    // The builder is behind a mutex, like in the agent (see AgentBuilder::parallel_startup).
+    let pipeline_builder = std::sync::Mutex::new(PipelineBuilder::new());
 
     // Check that creating the PluginStarter does not actually start the plugins.
     assert!(plugins.iter().all(|p| p.state == State::Initialized));
 
     // Start the plugins
     for p in plugins.iter_mut() {
-        let mut handle = AlumetStart::new(&mut pipeline_builder, p.name().to_owned());
+        let mut handle = AlumetStart::new(&pipeline_builder, p.name().to_owned());
         p.start(&mut handle)
             .unwrap_or_else(|err| panic!("Plugin failed to start: {} v{} - {}", p.name(), p.version(), err));
     }
     assert!(plugins.iter().all(|p| p.state == State::Started));
+    let pipeline_builder = pipeline_builder.into_inner().unwrap();
 
     // Check the registration of metrics and pipeline elements
     assert_eq!(4, pipeline_builder.metric_count());
@@ -12,6 +12,7 @@ use alumet::{
 use clap::{Args, Parser, Subcommand};
 use env_logger::Env;
 
+use plugin_binlog::BinlogPlugin;
 use plugin_csv::CsvPlugin;
 use plugin_perf::PerfPlugin;
 use plugin_rapl::RaplPlugin;
@@ -31,15 +32,20 @@ fn main() {
     let plugins = static_plugins![
         RaplPlugin,
         CsvPlugin,
+        BinlogPlugin,
         SocketControlPlugin,
         PerfPlugin,
-        plugin_influxdb::InfluxDbPlugin
+        plugin_influxdb::InfluxDbPlugin,
+        alumet::plugin::stats::SelfStatsPlugin
     ];
 
     // Build the measurement agent.
     let mut agent = AgentBuilder::new(plugins)
         .config_path("alumet-config.toml")
         .default_app_config(AppConfig::default())
+        // Some plugins block during startup (database connections, hardware probing),
+        // initialize and start them concurrently to shorten the measurement blackout on restart.
+        .parallel_startup()
         .build();
 
     // CLI option
@@ -111,6 +117,12 @@ fn apply_config(agent: &mut Agent, global_config: &mut AgentConfig, cli_args: Cl
     // Apply the config file
     let app_config: AppConfig = global_config.take_app_config().try_into().unwrap();
     agent.sources_max_update_interval(app_config.max_update_interval);
+    if let Some(cpus) = app_config.priority_thread_cpus {
+        agent.priority_thread_affinity(cpus);
+    }
+    if let Some(cpus) = app_config.normal_thread_cpus {
+        agent.normal_thread_affinity(cpus);
+    }
 
     // Apply the CLI args (they override the file)
     if let Some(max_update_interval) = cli_args.max_update_interval {
@@ -123,12 +135,27 @@ fn apply_config(agent: &mut Agent, global_config: &mut AgentConfig, cli_args: Cl
 struct AppConfig {
     #[serde(with = "humantime_serde")]
     max_update_interval: Duration,
+
+    /// Cores to pin the "realtime priority" measurement threads to.
+    ///
+    /// Use cores that are isolated from the rest of the system (kernel parameter
+    /// `isolcpus`) so that the measured workloads and the high-frequency polling
+    /// do not perturb each other.
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    priority_thread_cpus: Option<Vec<u32>>,
+
+    /// Cores to pin the other pipeline threads (transforms, outputs, ...) to,
+    /// e.g. to keep them away from the cores reserved for the measured workloads.
+    #[serde(default, skip_serializing_if = "Option::is_none")]
+    normal_thread_cpus: Option<Vec<u32>>,
 }
 
 impl Default for AppConfig {
     fn default() -> Self {
         Self {
             max_update_interval: Duration::from_millis(500),
+            priority_thread_cpus: None,
+            normal_thread_cpus: None,
         }
     }
 }
@@ -0,0 +1,132 @@
+//! Offline converter from the Alumet binary append-log to CSV.
+//!
+//! Usage: `binlog-to-csv <input.binlog> [output.csv]`
+//!
+//! Without an output file, the CSV is written to stdout.
+//! The columns are: metric, timestamp (RFC 3339), value, resource_kind, resource_id,
+//! consumer_kind, consumer_id, attributes (as `key=value` pairs, comma-separated).
+
+use std::{
+    borrow::Cow,
+    env,
+    fmt::Write as _,
+    fs::File,
+    io::{self, BufReader, BufWriter, Read, Write},
+};
+
+use anyhow::{anyhow, Context};
+use time::format_description::well_known::Rfc3339;
+use time::OffsetDateTime;
+
+use plugin_binlog::format::{LogReader, Record};
+
+const DELIMITER: char = ';';
+
+fn main() -> anyhow::Result<()> {
+    let mut args = env::args().skip(1);
+    let input_path = args
+        .next()
+        .ok_or_else(|| anyhow!("usage: binlog-to-csv <input.binlog> [output.csv]"))?;
+    let input = BufReader::new(File::open(&input_path).with_context(|| format!("failed to open {input_path}"))?);
+    match args.next() {
+        Some(output_path) => {
+            let output =
+                File::create(&output_path).with_context(|| format!("failed to create {output_path}"))?;
+            convert(input, BufWriter::new(output))
+        }
+        None => convert(input, BufWriter::new(io::stdout())),
+    }
+}
+
+fn convert(input: impl Read, mut output: impl Write) -> anyhow::Result<()> {
+    let mut reader = LogReader::new(input).context("invalid log header")?;
+
+    // the dictionaries of the log, indexed by id (ids are sequential, per kind)
+    let mut metrics: Vec<String> = Vec::new();
+    let mut resources: Vec<(String, String)> = Vec::new();
+    let mut consumers: Vec<(String, String)> = Vec::new();
+    let mut attr_keys: Vec<String> = Vec::new();
+
+    writeln!(
+        output,
+        "metric;timestamp;value;resource_kind;resource_id;consumer_kind;consumer_id;attributes"
+    )?;
+
+    let mut n_points = 0u64;
+    while let Some(record) = reader.next_record().context("failed to read record")? {
+        match record {
+            Record::MetricDef { id, name, unit } => {
+                debug_assert_eq!(id as usize, metrics.len());
+                let name = if unit.is_empty() || unit == "1" {
+                    name
+                } else {
+                    format!("{name}_{unit}")
+                };
+                metrics.push(name);
+            }
+            Record::ResourceDef { id, kind, resource_id } => {
+                debug_assert_eq!(id as usize, resources.len());
+                resources.push((kind, resource_id));
+            }
+            Record::ConsumerDef { id, kind, consumer_id } => {
+                debug_assert_eq!(id as usize, consumers.len());
+                consumers.push((kind, consumer_id));
+            }
+            Record::AttrKeyDef { id, key } => {
+                debug_assert_eq!(id as usize, attr_keys.len());
+                attr_keys.push(key);
+            }
+            Record::Point(p) => {
+                let metric = metrics.get(p.metric as usize).context("undefined metric id")?;
+                let (resource_kind, resource_id) =
+                    resources.get(p.resource as usize).context("undefined resource id")?;
+                let (consumer_kind, consumer_id) =
+                    consumers.get(p.consumer as usize).context("undefined consumer id")?;
+
+                let timestamp = OffsetDateTime::from_unix_timestamp_nanos(
+                    p.timestamp_secs as i128 * 1_000_000_000 + p.timestamp_nanos as i128,
+                )?
+                .format(&Rfc3339)?;
+                let value = match p.value {
+                    alumet::measurement::WrappedMeasurementValue::F64(x) => x.to_string(),
+                    alumet::measurement::WrappedMeasurementValue::U64(x) => x.to_string(),
+                };
+
+                let mut attributes = String::new();
+                for (key_id, value) in &p.attributes {
+                    let key = attr_keys.get(*key_id as usize).context("undefined attribute key id")?;
+                    if !attributes.is_empty() {
+                        attributes.push_str(", ");
+                    }
+                    write!(attributes, "{key}={value}")?;
+                }
+
+                writeln!(
+                    output,
+                    "{};{};{};{};{};{};{};{}",
+                    escape(metric),
+                    timestamp,
+                    value,
+                    escape(resource_kind),
+                    escape(resource_id),
+                    escape(consumer_kind),
+                    escape(consumer_id),
+                    escape(&attributes),
+                )?;
+                n_points += 1;
+            }
+        }
+    }
+    output.flush()?;
+    log::debug!("converted {n_points} points");
+    Ok(())
+}
+
+/// Escapes a CSV value, per RFC 4180.
+fn escape(s: &str) -> Cow<'_, str> {
+    if s.contains(&[DELIMITER, '"', '\n', '\r']) {
+        Cow::Owned(format!("\"{}\"", s.replace('"', "\"\"")))
+    } else {
+        Cow::Borrowed(s)
+    }
+}
@@ -0,0 +1,420 @@
+//! On-disk format of the binary append-log.
+//!
+//! The log is a stream of records, written once and never modified (append-only).
+//! All integers are little-endian, strings are UTF-8 bytes prefixed by a `u16` length.
+//!
+//! ## Layout
+//!
+//! The file starts with a 5-byte header: the magic bytes `ALMB` and a format version.
+//! Then come the records, each introduced by a one-byte tag:
+//! - *definition records* assign a small integer id to a metric, a resource,
+//!   a consumer or an attribute key; each definition is written once, the first
+//!   time the entity appears in the log;
+//! - *point records* are fixed-width (except for string attribute values) and only
+//!   contain ids, timestamps and values.
+//!
+//! Since the definitions always precede the points that use them, the log can be
+//! decoded in a single forward pass, see [`LogReader`].
+
+use std::io::{self, Read, Write};
+
+use alumet::measurement::{AttributeValue, WrappedMeasurementValue};
+
+/// Magic bytes at the start of every log file.
+pub const MAGIC: [u8; 4] = *b"ALMB";
+/// Version of the format, bump when the layout changes.
+pub const VERSION: u8 = 1;
+
+// Record tags.
+const TAG_METRIC_DEF: u8 = 1;
+const TAG_RESOURCE_DEF: u8 = 2;
+const TAG_CONSUMER_DEF: u8 = 3;
+const TAG_ATTR_KEY_DEF: u8 = 4;
+const TAG_POINT: u8 = 5;
+
+// Kinds of measurement values.
+const VALUE_U64: u8 = 0;
+const VALUE_F64: u8 = 1;
+
+// Kinds of attribute values.
+const ATTR_U64: u8 = 0;
+const ATTR_F64: u8 = 1;
+const ATTR_BOOL: u8 = 2;
+const ATTR_STR: u8 = 3;
+
+/// One decoded record of the log.
+#[derive(Debug, PartialEq)]
+pub enum Record {
+    /// Assigns `id` to a metric.
+    MetricDef { id: u32, name: String, unit: String },
+    /// Assigns `id` to a resource, in its textual form (kind + id).
+    ResourceDef { id: u32, kind: String, resource_id: String },
+    /// Assigns `id` to a resource consumer, in its textual form (kind + id).
+    ConsumerDef { id: u32, kind: String, consumer_id: String },
+    /// Assigns `id` to an attribute key.
+    AttrKeyDef { id: u32, key: String },
+    /// One measurement point, referring to previously defined ids.
+    Point(PointRecord),
+}
+
+/// A decoded measurement point.
+#[derive(Debug, PartialEq)]
+pub struct PointRecord {
+    pub metric: u32,
+    pub timestamp_secs: u64,
+    pub timestamp_nanos: u32,
+    pub value: WrappedMeasurementValue,
+    pub resource: u32,
+    pub consumer: u32,
+    pub attributes: Vec<(u32, AttributeValue)>,
+}
+
+/// Writes log records to an underlying [`Write`].
+///
+/// Wrap the destination in a [`std::io::BufWriter`]: the writer emits many small writes.
+pub struct LogWriter<W: Write> {
+    out: W,
+}
+
+impl<W: Write> LogWriter<W> {
+    /// Creates a writer and writes the file header.
+    pub fn new(mut out: W) -> io::Result<Self> {
+        out.write_all(&MAGIC)?;
+        out.write_all(&[VERSION])?;
+        Ok(Self { out })
+    }
+
+    /// Writes a metric definition record.
+    pub fn write_metric_def(&mut self, id: u32, name: &str, unit: &str) -> io::Result<()> {
+        self.out.write_all(&[TAG_METRIC_DEF])?;
+        self.out.write_all(&id.to_le_bytes())?;
+        write_str(&mut self.out, name)?;
+        write_str(&mut self.out, unit)
+    }
+
+    /// Writes a resource definition record.
+    pub fn write_resource_def(&mut self, id: u32, kind: &str, resource_id: &str) -> io::Result<()> {
+        self.out.write_all(&[TAG_RESOURCE_DEF])?;
+        self.out.write_all(&id.to_le_bytes())?;
+        write_str(&mut self.out, kind)?;
+        write_str(&mut self.out, resource_id)
+    }
+
+    /// Writes a consumer definition record.
+    pub fn write_consumer_def(&mut self, id: u32, kind: &str, consumer_id: &str) -> io::Result<()> {
+        self.out.write_all(&[TAG_CONSUMER_DEF])?;
+        self.out.write_all(&id.to_le_bytes())?;
+        write_str(&mut self.out, kind)?;
+        write_str(&mut self.out, consumer_id)
+    }
+
+    /// Writes an attribute key definition record.
+    pub fn write_attr_key_def(&mut self, id: u32, key: &str) -> io::Result<()> {
+        self.out.write_all(&[TAG_ATTR_KEY_DEF])?;
+        self.out.write_all(&id.to_le_bytes())?;
+        write_str(&mut self.out, key)
+    }
+
+    /// Writes a point record.
+    ///
+    /// The metric, resource, consumer and attribute key ids must have been defined
+    /// by an earlier record.
+    pub fn write_point(
+        &mut self,
+        metric: u32,
+        timestamp_secs: u64,
+        timestamp_nanos: u32,
+        value: &WrappedMeasurementValue,
+        resource: u32,
+        consumer: u32,
+        attributes: &[(u32, &AttributeValue)],
+    ) -> io::Result<()> {
+        self.out.write_all(&[TAG_POINT])?;
+        self.out.write_all(&metric.to_le_bytes())?;
+        self.out.write_all(&timestamp_secs.to_le_bytes())?;
+        self.out.write_all(&timestamp_nanos.to_le_bytes())?;
+        match value {
+            WrappedMeasurementValue::U64(x) => {
+                self.out.write_all(&[VALUE_U64])?;
+                self.out.write_all(&x.to_le_bytes())?;
+            }
+            WrappedMeasurementValue::F64(x) => {
+                self.out.write_all(&[VALUE_F64])?;
+                self.out.write_all(&x.to_le_bytes())?;
+            }
+        }
+        self.out.write_all(&resource.to_le_bytes())?;
+        self.out.write_all(&consumer.to_le_bytes())?;
+        let attr_count = u16::try_from(attributes.len())
+            .map_err(|_| io::Error::new(io::ErrorKind::InvalidInput, "too many attributes on one point"))?;
+        self.out.write_all(&attr_count.to_le_bytes())?;
+        for (key_id, value) in attributes {
+            self.out.write_all(&key_id.to_le_bytes())?;
+            match value {
+                AttributeValue::U64(x) => {
+                    self.out.write_all(&[ATTR_U64])?;
+                    self.out.write_all(&x.to_le_bytes())?;
+                }
+                AttributeValue::F64(x) => {
+                    self.out.write_all(&[ATTR_F64])?;
+                    self.out.write_all(&x.to_le_bytes())?;
+                }
+                AttributeValue::Bool(x) => {
+                    self.out.write_all(&[ATTR_BOOL, *x as u8])?;
+                }
+                AttributeValue::Str(s) => {
+                    self.out.write_all(&[ATTR_STR])?;
+                    write_str(&mut self.out, s)?;
+                }
+                AttributeValue::String(s) => {
+                    self.out.write_all(&[ATTR_STR])?;
+                    write_str(&mut self.out, s)?;
+                }
+            }
+        }
+        Ok(())
+    }
+
+    /// Flushes the underlying writer.
+    pub fn flush(&mut self) -> io::Result<()> {
+        self.out.flush()
+    }
+}
+
+/// Reads log records from an underlying [`Read`].
+///
+/// Wrap the source in a [`std::io::BufReader`]: the reader performs many small reads.
+pub struct LogReader<R: Read> {
+    input: R,
+}
+
+impl<R: Read> LogReader<R> {
+    /// Creates a reader and checks the file header.
+    pub fn new(mut input: R) -> io::Result<Self> {
+        let mut header = [0u8; 5];
+        input.read_exact(&mut header)?;
+        if header[..4] != MAGIC {
+            return Err(io::Error::new(io::ErrorKind::InvalidData, "not an Alumet binary log"));
+        }
+        if header[4] != VERSION {
+            return Err(io::Error::new(
+                io::ErrorKind::InvalidData,
+                format!("unsupported format version {}", header[4]),
+            ));
+        }
+        Ok(Self { input })
+    }
+
+    /// Reads the next record, or returns `None` at the end of the log.
+    pub fn next_record(&mut self) -> io::Result<Option<Record>> {
+        // detect a clean end-of-file on the tag byte
+        let mut tag = [0u8; 1];
+        match self.input.read_exact(&mut tag) {
+            Ok(()) => (),
+            Err(e) if e.kind() == io::ErrorKind::UnexpectedEof => return Ok(None),
+            Err(e) => return Err(e),
+        }
+        let record = match tag[0] {
+            TAG_METRIC_DEF => Record::MetricDef {
+                id: read_u32(&mut self.input)?,
+                name: read_str(&mut self.input)?,
+                unit: read_str(&mut self.input)?,
+            },
+            TAG_RESOURCE_DEF => Record::ResourceDef {
+                id: read_u32(&mut self.input)?,
+                kind: read_str(&mut self.input)?,
+                resource_id: read_str(&mut self.input)?,
+            },
+            TAG_CONSUMER_DEF => Record::ConsumerDef {
+                id: read_u32(&mut self.input)?,
+                kind: read_str(&mut self.input)?,
+                consumer_id: read_str(&mut self.input)?,
+            },
+            TAG_ATTR_KEY_DEF => Record::AttrKeyDef {
+                id: read_u32(&mut self.input)?,
+                key: read_str(&mut self.input)?,
+            },
+            TAG_POINT => {
+                let metric = read_u32(&mut self.input)?;
+                let timestamp_secs = read_u64(&mut self.input)?;
+                let timestamp_nanos = read_u32(&mut self.input)?;
+                let value = match read_u8(&mut self.input)? {
+                    VALUE_U64 => WrappedMeasurementValue::U64(read_u64(&mut self.input)?),
+                    VALUE_F64 => WrappedMeasurementValue::F64(read_f64(&mut self.input)?),
+                    k => return Err(invalid_data(format!("invalid value kind {k}"))),
+                };
+                let resource = read_u32(&mut self.input)?;
+                let consumer = read_u32(&mut self.input)?;
+                let attr_count = read_u16(&mut self.input)?;
+                let mut attributes = Vec::with_capacity(attr_count as usize);
+                for _ in 0..attr_count {
+                    let key_id = read_u32(&mut self.input)?;
+                    let value = match read_u8(&mut self.input)? {
+                        ATTR_U64 => AttributeValue::U64(read_u64(&mut self.input)?),
+                        ATTR_F64 => AttributeValue::F64(read_f64(&mut self.input)?),
+                        ATTR_BOOL => AttributeValue::Bool(read_u8(&mut self.input)? != 0),
+                        ATTR_STR => AttributeValue::String(read_str(&mut self.input)?),
+                        k => return Err(invalid_data(format!("invalid attribute kind {k}"))),
+                    };
+                    attributes.push((key_id, value));
+                }
+                Record::Point(PointRecord {
+                    metric,
+                    timestamp_secs,
+                    timestamp_nanos,
+                    value,
+                    resource,
+                    consumer,
+                    attributes,
+                })
+            }
+            t => return Err(invalid_data(format!("invalid record tag {t}"))),
+        };
+        Ok(Some(record))
+    }
+}
+
+fn invalid_data(msg: String) -> io::Error {
+    io::Error::new(io::ErrorKind::InvalidData, msg)
+}
+
+fn write_str(out: &mut impl Write, s: &str) -> io::Result<()> {
+    let len = u16::try_from(s.len())
+        .map_err(|_| io::Error::new(io::ErrorKind::InvalidInput, "string too long for the log format"))?;
+    out.write_all(&len.to_le_bytes())?;
+    out.write_all(s.as_bytes())
+}
+
+fn read_u8(input: &mut impl Read) -> io::Result<u8> {
+    let mut buf = [0u8; 1];
+    input.read_exact(&mut buf)?;
+    Ok(buf[0])
+}
+
+fn read_u16(input: &mut impl Read) -> io::Result<u16> {
+    let mut buf = [0u8; 2];
+    input.read_exact(&mut buf)?;
+    Ok(u16::from_le_bytes(buf))
+}
+
+fn read_u32(input: &mut impl Read) -> io::Result<u32> {
+    let mut buf = [0u8; 4];
+    input.read_exact(&mut buf)?;
+    Ok(u32::from_le_bytes(buf))
+}
+
+fn read_u64(input: &mut impl Read) -> io::Result<u64> {
+    let mut buf = [0u8; 8];
+    input.read_exact(&mut buf)?;
+    Ok(u64::from_le_bytes(buf))
+}
+
+fn read_f64(input: &mut impl Read) -> io::Result<f64> {
+    let mut buf = [0u8; 8];
+    input.read_exact(&mut buf)?;
+    Ok(f64::from_le_bytes(buf))
+}
+
+fn read_str(input: &mut impl Read) -> io::Result<String> {
+    let len = read_u16(input)? as usize;
+    let mut buf = vec![0u8; len];
+    input.read_exact(&mut buf)?;
+    String::from_utf8(buf).map_err(|e| io::Error::new(io::ErrorKind::InvalidData, e))
+}
+
+#[cfg(test)]
+mod tests {
+    use alumet::measurement::{AttributeValue, WrappedMeasurementValue};
+    use pretty_assertions::assert_eq;
+
+    use super::{LogReader, LogWriter, PointRecord, Record};
+
+    #[test]
+    fn round_trip() {
+        let mut log = Vec::new();
+        let mut writer = LogWriter::new(&mut log).unwrap();
+        writer.write_metric_def(0, "cpu_energy", "J").unwrap();
+        writer.write_resource_def(0, "cpu_package", "0").unwrap();
+        writer.write_consumer_def(0, "local_machine", "").unwrap();
+        writer.write_attr_key_def(0, "domain").unwrap();
+        writer
+            .write_point(
+                0,
+                1_700_000_000,
+                123_456_789,
+                &WrappedMeasurementValue::F64(42.5),
+                0,
+                0,
+                &[(0, &AttributeValue::Str("package"))],
+            )
+            .unwrap();
+        writer
+            .write_point(0, 1_700_000_001, 0, &WrappedMeasurementValue::U64(7), 0, 0, &[])
+            .unwrap();
+        writer.flush().unwrap();
+
+        let mut reader = LogReader::new(log.as_slice()).unwrap();
+        assert_eq!(
+            reader.next_record().unwrap(),
+            Some(Record::MetricDef {
+                id: 0,
+                name: "cpu_energy".into(),
+                unit: "J".into()
+            })
+        );
+        assert_eq!(
+            reader.next_record().unwrap(),
+            Some(Record::ResourceDef {
+                id: 0,
+                kind: "cpu_package".into(),
+                resource_id: "0".into()
+            })
+        );
+        assert_eq!(
+            reader.next_record().unwrap(),
+            Some(Record::ConsumerDef {
+                id: 0,
+                kind: "local_machine".into(),
+                consumer_id: "".into()
+            })
+        );
+        assert_eq!(
+            reader.next_record().unwrap(),
+            Some(Record::AttrKeyDef {
+                id: 0,
+                key: "domain".into()
+            })
+        );
+        assert_eq!(
+            reader.next_record().unwrap(),
+            Some(Record::Point(PointRecord {
+                metric: 0,
+                timestamp_secs: 1_700_000_000,
+                timestamp_nanos: 123_456_789,
+                value: WrappedMeasurementValue::F64(42.5),
+                resource: 0,
+                consumer: 0,
+                attributes: vec![(0, AttributeValue::String("package".into()))],
+            }))
+        );
+        assert_eq!(
+            reader.next_record().unwrap(),
+            Some(Record::Point(PointRecord {
+                metric: 0,
+                timestamp_secs: 1_700_000_001,
+                timestamp_nanos: 0,
+                value: WrappedMeasurementValue::U64(7),
+                resource: 0,
+                consumer: 0,
+                attributes: vec![],
+            }))
+        );
+        assert_eq!(reader.next_record().unwrap(), None);
+    }
+
+    #[test]
+    fn bad_header() {
+        assert!(LogReader::new(&b"NOPE\x01xxxx"[..]).is_err());
+        assert!(LogReader::new(&b"ALMB\xff"[..]).is_err());
+    }
+}
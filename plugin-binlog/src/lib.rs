@@ -0,0 +1,59 @@
+pub mod format;
+mod output;
+
+use std::path::PathBuf;
+
+use alumet::plugin::{
+    rust::{deserialize_config, serialize_config, AlumetPlugin},
+    ConfigTable,
+};
+use output::BinlogOutput;
+use serde::{Deserialize, Serialize};
+
+pub struct BinlogPlugin {
+    config: Config,
+}
+
+impl AlumetPlugin for BinlogPlugin {
+    fn name() -> &'static str {
+        "binlog"
+    }
+
+    fn version() -> &'static str {
+        env!("CARGO_PKG_VERSION")
+    }
+
+    fn default_config() -> anyhow::Result<Option<ConfigTable>> {
+        Ok(Some(serialize_config(Config::default())?))
+    }
+
+    fn init(config: ConfigTable) -> anyhow::Result<Box<Self>> {
+        let config: Config = deserialize_config(config)?;
+        Ok(Box::new(BinlogPlugin { config }))
+    }
+
+    fn start(&mut self, alumet: &mut alumet::plugin::AlumetStart) -> anyhow::Result<()> {
+        let output = Box::new(BinlogOutput::new(&self.config.output_path, self.config.force_flush)?);
+        alumet.add_output(output);
+        Ok(())
+    }
+
+    fn stop(&mut self) -> anyhow::Result<()> {
+        Ok(())
+    }
+}
+
+#[derive(Deserialize, Serialize)]
+struct Config {
+    output_path: PathBuf,
+    force_flush: bool,
+}
+
+impl Default for Config {
+    fn default() -> Self {
+        Self {
+            output_path: PathBuf::from("alumet-output.binlog"),
+            force_flush: true,
+        }
+    }
+}
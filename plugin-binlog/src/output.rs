@@ -0,0 +1,134 @@
+use std::{
+    collections::HashMap,
+    fs::File,
+    io::{self, BufWriter},
+    path::Path,
+    time::{SystemTime, UNIX_EPOCH},
+};
+
+use alumet::{
+    measurement::{AttributeValue, MeasurementBuffer},
+    metrics::RawMetricId,
+    pipeline::OutputContext,
+    resources::{Resource, ResourceConsumer},
+};
+use anyhow::Context;
+
+use crate::format::LogWriter;
+
+/// An output that appends the measurements to a compact binary log.
+///
+/// Unlike `CsvOutput`, nothing is formatted as text on the hot path: points are
+/// written as fixed-width binary records, and the metrics, resources, consumers
+/// and attribute keys are dictionary-encoded (their definition is written once,
+/// the first time they appear, and the points only carry small integer ids).
+/// See [`crate::format`] for the layout, and the `binlog-to-csv` tool to convert
+/// a log to CSV offline.
+pub struct BinlogOutput {
+    /// parameter: do we flush after each write(measurements)?
+    force_flush: bool,
+
+    /// Log writer over a buffered file.
+    writer: LogWriter<BufWriter<File>>,
+
+    // Dictionaries: entities that have already been defined in the log, and their ids.
+    metric_ids: HashMap<RawMetricId, u32>,
+    resource_ids: HashMap<Resource, u32>,
+    consumer_ids: HashMap<ResourceConsumer, u32>,
+    attr_key_ids: HashMap<String, u32>,
+}
+
+impl BinlogOutput {
+    pub fn new(output_file: impl AsRef<Path>, force_flush: bool) -> io::Result<Self> {
+        let writer = LogWriter::new(BufWriter::new(File::create(output_file)?))?;
+        Ok(Self {
+            force_flush,
+            writer,
+            metric_ids: HashMap::new(),
+            resource_ids: HashMap::new(),
+            consumer_ids: HashMap::new(),
+            attr_key_ids: HashMap::new(),
+        })
+    }
+}
+
+impl alumet::pipeline::Output for BinlogOutput {
+    fn write(
+        &mut self,
+        measurements: &MeasurementBuffer,
+        ctx: &OutputContext,
+    ) -> Result<(), alumet::pipeline::WriteError> {
+        for m in measurements.iter() {
+            // dictionary-encode the metric, defining it on first occurrence
+            let metric_id = match self.metric_ids.get(&m.metric) {
+                Some(id) => *id,
+                None => {
+                    let full_metric = ctx
+                        .metrics
+                        .with_id(&m.metric)
+                        .with_context(|| format!("Unknown metric {:?}", m.metric))?;
+                    let id = self.metric_ids.len() as u32;
+                    self.writer
+                        .write_metric_def(id, &full_metric.name, &full_metric.unit.unique_name())?;
+                    self.metric_ids.insert(m.metric, id);
+                    id
+                }
+            };
+
+            // same for the resource and the consumer
+            let resource_id = match self.resource_ids.get(&m.resource) {
+                Some(id) => *id,
+                None => {
+                    let id = self.resource_ids.len() as u32;
+                    self.writer
+                        .write_resource_def(id, m.resource.kind(), &m.resource.id_display().to_string())?;
+                    self.resource_ids.insert(m.resource.clone(), id);
+                    id
+                }
+            };
+            let consumer_id = match self.consumer_ids.get(&m.consumer) {
+                Some(id) => *id,
+                None => {
+                    let id = self.consumer_ids.len() as u32;
+                    self.writer
+                        .write_consumer_def(id, m.consumer.kind(), &m.consumer.id_display().to_string())?;
+                    self.consumer_ids.insert(m.consumer.clone(), id);
+                    id
+                }
+            };
+
+            // dictionary-encode the attribute keys (most points have no attributes)
+            let mut attributes: Vec<(u32, &AttributeValue)> = Vec::with_capacity(m.attributes_len());
+            for (key, value) in m.attributes() {
+                let key_id = match self.attr_key_ids.get(key) {
+                    Some(id) => *id,
+                    None => {
+                        let id = self.attr_key_ids.len() as u32;
+                        self.writer.write_attr_key_def(id, key)?;
+                        self.attr_key_ids.insert(key.to_owned(), id);
+                        id
+                    }
+                };
+                attributes.push((key_id, value));
+            }
+
+            let timestamp = SystemTime::from(m.timestamp)
+                .duration_since(UNIX_EPOCH)
+                .unwrap_or_default();
+            self.writer.write_point(
+                metric_id,
+                timestamp.as_secs(),
+                timestamp.subsec_nanos(),
+                &m.value,
+                resource_id,
+                consumer_id,
+                &attributes,
+            )?;
+        }
+        if self.force_flush {
+            log::trace!("flushing LogWriter");
+            self.writer.flush()?;
+        }
+        Ok(())
+    }
+}
@@ -0,0 +1,56 @@
+//! Benchmarks of the CSV formatting helper, which runs once per measurement point.
+//!
+//! Run with `cargo bench -p plugin-csv`.
+
+use criterion::{black_box, criterion_group, criterion_main, BatchSize, Criterion, Throughput};
+
+use plugin_csv::csv::CsvHelper;
+
+/// Number of records written per iteration, one record per measurement point.
+const N_RECORDS: usize = 1000;
+
+fn bench_escape(c: &mut Criterion) {
+    let helper = CsvHelper::new(';', "\"\"".into());
+    let mut group = c.benchmark_group("escape_string");
+
+    // the common case: nothing to escape, no allocation
+    group.bench_function("clean", |b| b.iter(|| helper.escape_string(black_box("total_usage_usec"))));
+    // the value contains the delimiter, it must be quoted (allocates)
+    group.bench_function("quoted", |b| b.iter(|| helper.escape_string(black_box("a;value;with;delimiters"))));
+    group.finish();
+}
+
+fn bench_writeln(c: &mut Criterion) {
+    let helper = CsvHelper::new(';', "\"\"".into());
+    // a record shaped like a real output row: metric, value, resource, consumer, timestamp, attributes
+    let record = [
+        "rapl_consumed_energy_J_um",
+        "152893",
+        "cpu_package",
+        "0",
+        "local_machine",
+        "",
+        "2026-08-31T12:00:00.123456789Z",
+        "false",
+        "",
+    ];
+
+    let mut group = c.benchmark_group("writeln");
+    group.throughput(Throughput::Elements(N_RECORDS as u64));
+    group.bench_function("1000_records", |b| {
+        b.iter_batched(
+            || Vec::<u8>::with_capacity(N_RECORDS * 100),
+            |mut out| {
+                for _ in 0..N_RECORDS {
+                    helper.writeln(&mut out, record).unwrap();
+                }
+                out
+            },
+            BatchSize::LargeInput,
+        )
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_escape, bench_writeln);
+criterion_main!(benches);
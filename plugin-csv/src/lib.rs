@@ -1,4 +1,4 @@
-mod csv;
+pub mod csv; // public so that the benchmarks can exercise the formatting helper
 mod output;
 // TODO mod input
 
@@ -0,0 +1,61 @@
+//! Benchmarks of the line protocol serializer, which runs once per measurement point.
+//!
+//! Run with `cargo bench -p plugin-influxdb`.
+
+use std::time::{Duration, UNIX_EPOCH};
+
+use criterion::{criterion_group, criterion_main, BatchSize, Criterion, Throughput};
+
+use alumet::measurement::Timestamp;
+use plugin_influxdb::influxdb2::LineProtocolBuilder;
+
+/// Number of lines built per iteration, one line per measurement point.
+const N_LINES: usize = 1000;
+
+fn build_lines(builder: &mut LineProtocolBuilder, timestamp: Timestamp) {
+    for i in 0..N_LINES {
+        builder
+            .measurement("rapl_consumed_energy")
+            .tag("resource_kind", "cpu_package")
+            .tag("resource_id", "0")
+            .tag("resource_consumer_kind", "local_machine")
+            .field_uint("value", i as u64)
+            .timestamp(timestamp);
+    }
+}
+
+fn bench_builder(c: &mut Criterion) {
+    let timestamp = Timestamp::from(UNIX_EPOCH + Duration::from_nanos(1556813561098000000));
+    let mut group = c.benchmark_group("LineProtocolBuilder");
+    group.throughput(Throughput::Elements(N_LINES as u64));
+
+    // a fresh builder per batch, as before the batching rework
+    group.bench_function("fresh_builder", |b| {
+        b.iter_batched(
+            LineProtocolBuilder::new,
+            |mut builder| {
+                build_lines(&mut builder, timestamp);
+                builder
+            },
+            BatchSize::LargeInput,
+        )
+    });
+
+    // a long-lived builder cleared between batches, as in the output: the buffer
+    // grows once and every subsequent batch is built without allocating
+    group.bench_function("reused_builder", |b| {
+        let mut builder = LineProtocolBuilder::new();
+        build_lines(&mut builder, timestamp); // warm up the capacity
+        builder.clear();
+        b.iter(|| {
+            build_lines(&mut builder, timestamp);
+            let len = builder.len();
+            builder.clear();
+            len
+        })
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_builder);
+criterion_main!(benches);
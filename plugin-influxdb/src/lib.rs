@@ -1,4 +1,9 @@
-use std::collections::HashSet;
+use std::{
+    collections::HashSet,
+    io::Write,
+    sync::Arc,
+    time::{Duration, Instant},
+};
 
 use alumet::{
     measurement::{AttributeValue, WrappedMeasurementValue},
@@ -6,11 +11,19 @@ use alumet::{
     plugin::rust::{deserialize_config, serialize_config, AlumetPlugin},
 };
 use anyhow::Context;
+use flate2::{write::GzEncoder, Compression};
 use serde::{Deserialize, Serialize};
+use tokio::sync::Semaphore;
+
+use crate::influxdb2::LineProtocolBuilder;
 
-use crate::influxdb2::LineProtocolData;
+pub mod influxdb2; // public so that the benchmarks can exercise the line protocol serializer
 
-mod influxdb2;
+/// Maximum number of concurrent write requests to InfluxDB.
+///
+/// Sending is detached from the pipeline (see [`InfluxDbOutput::send_batch`]); this limit
+/// applies backpressure to the output task if InfluxDB cannot keep up with the batches.
+const MAX_IN_FLIGHT_REQUESTS: usize = 4;
 
 pub struct InfluxDbPlugin {
     config: Option<Config>,
@@ -58,6 +71,12 @@ impl AlumetPlugin for InfluxDbPlugin {
             attributes_as: config.attributes_as,
             attributes_as_tags: config.attributes_as_tags.unwrap_or_default(),
             attributes_as_fields: config.attributes_as_fields.unwrap_or_default(),
+            batch: LineProtocolBuilder::new(),
+            batch_started: None,
+            batch_size_bytes: config.batch_size_bytes,
+            batch_max_delay: Duration::from_secs(config.batch_max_delay_seconds),
+            send_attempts: config.send_attempts.max(1),
+            send_limiter: Arc::new(Semaphore::new(MAX_IN_FLIGHT_REQUESTS)),
         }));
         Ok(())
     }
@@ -74,6 +93,123 @@ struct InfluxDbOutput {
     attributes_as: AttributeAs,
     attributes_as_tags: HashSet<String>,
     attributes_as_fields: HashSet<String>,
+
+    /// Line protocol data accumulated across flushes, in a reusable grow-only buffer.
+    batch: LineProtocolBuilder,
+    /// When the oldest data of the current batch was buffered.
+    batch_started: Option<Instant>,
+    /// parameter: send the batch when it exceeds this size.
+    batch_size_bytes: usize,
+    /// parameter: send the batch when its oldest data is older than this.
+    batch_max_delay: Duration,
+    /// parameter: how many times to attempt each write request.
+    send_attempts: u32,
+    /// Limits the number of concurrent write requests.
+    send_limiter: Arc<Semaphore>,
+}
+
+impl InfluxDbOutput {
+    /// Compresses the current batch and resets it (keeping its capacity).
+    ///
+    /// Returns `None` if the batch is empty.
+    fn compress_batch(&mut self) -> anyhow::Result<Option<Vec<u8>>> {
+        if self.batch.is_empty() {
+            return Ok(None);
+        }
+
+        // gzip the line protocol body (it is repetitive text, this shrinks it a lot)
+        let mut encoder = GzEncoder::new(Vec::new(), Compression::fast());
+        encoder.write_all(self.batch.as_bytes())?;
+        let body = encoder.finish()?;
+        log::debug!(
+            "sending batch of {} bytes ({} gzipped) to InfluxDB",
+            self.batch.len(),
+            body.len()
+        );
+        self.batch.clear();
+        self.batch_started = None;
+        Ok(Some(body))
+    }
+
+    /// Compresses and sends the current batch.
+    ///
+    /// The request is performed by a detached task with retry and exponential backoff,
+    /// so a slow or temporarily unavailable InfluxDB does not block the output
+    /// (which would make it lag behind the measurement broadcast and lose data).
+    /// The number of in-flight requests is bounded by `send_limiter`.
+    fn send_batch(&mut self) -> anyhow::Result<()> {
+        let Some(body) = self.compress_batch()? else {
+            return Ok(());
+        };
+
+        // Output::write runs on a blocking thread, block_on is fine here (and applies
+        // backpressure when too many requests are already in flight).
+        let handle = tokio::runtime::Handle::current();
+        let permit = handle
+            .block_on(self.send_limiter.clone().acquire_owned())
+            .expect("send_limiter should not be closed");
+
+        let client = self.client.clone();
+        let org = self.org.clone();
+        let bucket = self.bucket.clone();
+        let attempts = self.send_attempts;
+        handle.spawn(async move {
+            let _permit = permit; // released when the task finishes
+            let mut delay = Duration::from_secs(1);
+            for attempt in 1..=attempts {
+                match client.write_gzip(&org, &bucket, body.clone()).await {
+                    Ok(()) => return,
+                    Err(e) if attempt < attempts => {
+                        log::warn!(
+                            "write to InfluxDB failed (attempt {attempt}/{attempts}), retrying in {delay:?}: {e:#}"
+                        );
+                        tokio::time::sleep(delay).await;
+                        delay *= 2;
+                    }
+                    Err(e) => {
+                        log::error!(
+                            "write to InfluxDB failed after {attempts} attempts, {} bytes of measurements are lost: {e:#}",
+                            body.len()
+                        );
+                    }
+                }
+            }
+        });
+        Ok(())
+    }
+}
+
+impl Drop for InfluxDbOutput {
+    fn drop(&mut self) {
+        // Send the measurements that have not reached the size or delay threshold yet:
+        // without this, every shutdown would lose up to `batch_max_delay` of measurements.
+        // The send is synchronous and attempted once (no retry, no backoff): a detached
+        // task would be cancelled when the pipeline runtime shuts down right after.
+        let body = match self.compress_batch() {
+            Ok(Some(body)) => body,
+            Ok(None) => return,
+            Err(e) => {
+                log::error!("failed to compress the last batch for InfluxDB, its measurements are lost: {e:#}");
+                return;
+            }
+        };
+        let send = self.client.write_gzip(&self.org, &self.bucket, body);
+        let res = match tokio::runtime::Handle::try_current() {
+            // The output is dropped by a task of the pipeline runtime.
+            Ok(handle) => tokio::task::block_in_place(|| handle.block_on(send)),
+            // No runtime here (e.g. the pipeline failed to start): use a temporary one.
+            Err(_) => match tokio::runtime::Builder::new_current_thread().enable_all().build() {
+                Ok(rt) => rt.block_on(send),
+                Err(e) => {
+                    log::error!("failed to start a runtime to send the last batch to InfluxDB: {e:#}");
+                    return;
+                }
+            },
+        };
+        if let Err(e) = res {
+            log::error!("failed to send the last batch to InfluxDB, its measurements are lost: {e:#}");
+        }
+    }
 }
 
 impl Output for InfluxDbOutput {
@@ -82,8 +218,11 @@ impl Output for InfluxDbOutput {
         measurements: &alumet::measurement::MeasurementBuffer,
         ctx: &alumet::pipeline::OutputContext,
     ) -> Result<(), alumet::pipeline::WriteError> {
-        // Build the data to send to InfluxDB.
-        let mut builder = LineProtocolData::builder();
+        // Append the measurements to the current batch (the buffer is reused across flushes).
+        if self.batch.is_empty() && measurements.len() > 0 {
+            self.batch_started = Some(Instant::now());
+        }
+        let builder = &mut self.batch;
         for m in measurements {
             let metric = ctx.metrics.with_id(&m.metric).unwrap();
             builder.measurement(&metric.name);
@@ -154,14 +293,17 @@ impl Output for InfluxDbOutput {
             // And the timestamp comes last.
             builder.timestamp(m.timestamp);
         }
-        let data = builder.build();
-        log::debug!("Line protocol data: {data:?}");
 
-        // Do the writing on the tokio Runtime.
-        let handle = tokio::runtime::Handle::current();
-        handle
-            .block_on(self.client.write(&self.org, &self.bucket, data))
-            .context("failed to write measurements to InfluxDB")?;
+        // Send the batch when it is big enough, or when its oldest data gets too old.
+        // Coalescing several flushes into one request keeps the requests large and few,
+        // which is much friendlier to the InfluxDB ingest endpoint than one small
+        // request per flushed buffer.
+        let deadline_reached = self
+            .batch_started
+            .is_some_and(|started| started.elapsed() >= self.batch_max_delay);
+        if self.batch.len() >= self.batch_size_bytes || deadline_reached {
+            self.send_batch().context("failed to send measurements to InfluxDB")?;
+        }
         Ok(())
     }
 }
@@ -175,6 +317,13 @@ struct Config {
     attributes_as: AttributeAs,
     attributes_as_tags: Option<HashSet<String>>,
     attributes_as_fields: Option<HashSet<String>>,
+    /// Send the accumulated measurements when their line protocol form exceeds this size.
+    batch_size_bytes: usize,
+    /// Send the accumulated measurements when the oldest ones are older than this,
+    /// even if `batch_size_bytes` is not reached.
+    batch_max_delay_seconds: u64,
+    /// How many times to attempt each write request (with exponential backoff in between).
+    send_attempts: u32,
 }
 
 /// How to serialize Alumet attributes by default?
@@ -199,6 +348,9 @@ impl Default for Config {
             attributes_as: AttributeAs::Field,
             attributes_as_tags: None,
             attributes_as_fields: None,
+            batch_size_bytes: 512 * 1024,
+            batch_max_delay_seconds: 10,
+            send_attempts: 4,
         }
     }
 }
@@ -4,7 +4,8 @@ use serde_json::Value;
 use std::{
     collections::HashMap,
     fs::{self, File},
-    io::{Read, Seek},
+    io::ErrorKind,
+    os::unix::fs::FileExt,
     path::{Path, PathBuf},
     process::Command,
     result::Result::Ok,
@@ -161,15 +162,49 @@ pub fn list_all_k8s_pods_file(
     return Ok(final_li_metric_file);
 }
 
+/// Initial size of the read buffer, enough to hold a whole `cpu.stat` file
+/// (about a hundred bytes) with room to spare.
+const INITIAL_BUFFER_SIZE: usize = 1024;
+
+/// Reads the whole file into `buf` with `pread` calls at increasing offsets.
+///
+/// The file descriptor is kept open between polls and `pread` does not move the
+/// file cursor, so there is no `rewind` (lseek) to undo afterwards: a file that
+/// fits in the buffer, which is the common case, costs a single syscall per poll.
+/// The buffer is reused across polls and only grows if the file does.
+fn read_all_at(file: &File, buf: &mut Vec<u8>) -> std::io::Result<()> {
+    if buf.capacity() == 0 {
+        buf.reserve(INITIAL_BUFFER_SIZE);
+    }
+    buf.resize(buf.capacity(), 0);
+    let mut total = 0;
+    loop {
+        let n = match file.read_at(&mut buf[total..], total as u64) {
+            Ok(n) => n,
+            Err(e) if e.kind() == ErrorKind::Interrupted => continue,
+            Err(e) => return Err(e),
+        };
+        total += n;
+        if n == 0 || total < buf.len() {
+            // cgroup files produce their whole content in one read,
+            // a short read means that we have everything
+            break;
+        }
+        // the buffer is full, the file may be bigger: grow and read the rest
+        buf.resize(buf.len() * 2, 0);
+    }
+    buf.truncate(total);
+    Ok(())
+}
+
 /// Extracts the metrics from the file.
-pub fn gather_value(file: &mut CgroupV2MetricFile, content_buffer: &mut String) -> anyhow::Result<CgroupV2Metric> {
-    content_buffer.clear(); //Clear before use
-    file.file
-        .read_to_string(content_buffer)
+pub fn gather_value(file: &mut CgroupV2MetricFile, content_buffer: &mut Vec<u8>) -> anyhow::Result<CgroupV2Metric> {
+    read_all_at(&file.file, content_buffer)
         .with_context(|| format!("Unable to gather cgroup v2 metrics by reading file {}", file.name))?;
-    file.file.rewind()?;
+    let content = std::str::from_utf8(content_buffer)
+        .with_context(|| format!("file {} contains invalid UTF-8", file.name))?;
     let mut new_metric =
-        CgroupV2Metric::from_str(&content_buffer).with_context(|| format!("failed to parse {}", file.name))?;
+        CgroupV2Metric::from_str(content).with_context(|| format!("failed to parse {}", file.name))?;
     new_metric.name = file.name.clone();
     new_metric.namespace = file.namespace.clone();
     new_metric.uid = file.uid.clone();
@@ -449,6 +484,32 @@ mod tests {
         }
         assert!(true);
     }
+    #[test]
+    fn test_read_all_at() {
+        let tmp = std::env::temp_dir();
+        let root: std::path::PathBuf = tmp.join("test-alumet-plugin-k8s/read-all-at");
+        if root.exists() {
+            std::fs::remove_dir_all(&root).unwrap();
+        }
+        std::fs::create_dir_all(&root).unwrap();
+        // a file bigger than the initial buffer, to check that the buffer grows
+        let big_content = "usage_usec 1234\n".repeat(2 * INITIAL_BUFFER_SIZE / 16);
+        let big_path = root.join("big");
+        std::fs::write(&big_path, &big_content).unwrap();
+        let big_file = File::open(&big_path).unwrap();
+
+        let mut buf = Vec::new();
+        read_all_at(&big_file, &mut buf).unwrap();
+        assert_eq!(buf, big_content.as_bytes());
+
+        // the buffer is reused for a smaller file without keeping stale data
+        let small_path = root.join("small");
+        std::fs::write(&small_path, "usage_usec 8\n").unwrap();
+        let small_file = File::open(&small_path).unwrap();
+        read_all_at(&small_file, &mut buf).unwrap();
+        assert_eq!(buf, b"usage_usec 8\n");
+    }
+
     #[test]
     fn test_gather_value() {
         let tmp = std::env::temp_dir();
@@ -489,7 +550,7 @@ mod tests {
             "namespace_test".to_string(),
             "node_test".to_owned(),
         );
-        let mut content_file = String::new();
+        let mut content_file = Vec::new();
         let res_metric = gather_value(&mut my_cgroup_test_file, &mut content_file);
         if let Ok(CgroupV2Metric {
             name,
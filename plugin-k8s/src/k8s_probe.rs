@@ -1,5 +1,6 @@
 use alumet::{
-    measurement::{AttributeValue, MeasurementAccumulator, MeasurementPoint, Timestamp},
+    interning::intern,
+    measurement::{MeasurementAccumulator, MeasurementPoint, Timestamp},
     metrics::{MetricCreationError, TypedMetricId},
     plugin::{
         util::{CounterDiff, CounterDiffUpdate},
@@ -21,6 +22,8 @@ pub struct K8SProbe {
     pub time_used_tot: TypedMetricId<u64>,
     pub time_used_user_mode: TypedMetricId<u64>,
     pub time_used_system_mode: TypedMetricId<u64>,
+    /// Buffer that receives the file content, reused across polls to avoid reallocating.
+    file_buffer: Vec<u8>,
 }
 
 #[derive(Clone)]
@@ -46,6 +49,7 @@ impl K8SProbe {
             time_used_tot: metric.time_used_tot,
             time_used_system_mode: metric.time_used_system_mode,
             time_used_user_mode: metric.time_used_user_mode,
+            file_buffer: Vec::new(),
         });
     }
 }
@@ -56,8 +60,7 @@ impl alumet::pipeline::Source for K8SProbe {
         measurements: &mut MeasurementAccumulator,
         timestamp: Timestamp,
     ) -> Result<(), alumet::pipeline::PollError> {
-        let mut file_buffer = String::new();
-        let metrics: CgroupV2Metric = cgroup_v2::gather_value(&mut self.cgroup_v2_metric_file, &mut file_buffer)?;
+        let metrics: CgroupV2Metric = cgroup_v2::gather_value(&mut self.cgroup_v2_metric_file, &mut self.file_buffer)?;
         let diff_tot = match self.time_tot.update(metrics.time_used_tot) {
             CounterDiffUpdate::FirstTime => None,
             CounterDiffUpdate::Difference(diff) | CounterDiffUpdate::CorrectedDifference(diff) => Some(diff),
@@ -75,6 +78,12 @@ impl alumet::pipeline::Source for K8SProbe {
         let consumer = ResourceConsumer::ControlGroup {
             path: (self.cgroup_v2_metric_file.path.to_string_lossy().to_string().into()),
         };
+        // These attribute values are repeated on every point of every poll:
+        // intern them once so that attaching them is a copy, not a String allocation.
+        let uid = intern(&metrics.uid);
+        let name = intern(&metrics.name);
+        let namespace = intern(&metrics.namespace);
+        let node = intern(&metrics.node);
         if let Some(value_tot) = diff_tot {
             let p_tot: MeasurementPoint = MeasurementPoint::new(
                 timestamp,
@@ -83,10 +92,10 @@ impl alumet::pipeline::Source for K8SProbe {
                 consumer.clone(),
                 value_tot as u64,
             )
-            .with_attr("uid", AttributeValue::String(metrics.uid.clone()))
-            .with_attr("name", AttributeValue::String(metrics.name.clone()))
-            .with_attr("namespace", AttributeValue::String(metrics.namespace.clone()))
-            .with_attr("node", AttributeValue::String(metrics.node.clone()));
+            .with_attr("uid", uid)
+            .with_attr("name", name)
+            .with_attr("namespace", namespace)
+            .with_attr("node", node);
             measurements.push(p_tot);
         }
         if let Some(value_usr) = diff_usr {
@@ -97,10 +106,10 @@ impl alumet::pipeline::Source for K8SProbe {
                 consumer.clone(),
                 value_usr as u64,
             )
-            .with_attr("uid", AttributeValue::String(metrics.uid.clone()))
-            .with_attr("name", AttributeValue::String(metrics.name.clone()))
-            .with_attr("namespace", AttributeValue::String(metrics.namespace.clone()))
-            .with_attr("node", AttributeValue::String(metrics.node.clone()));
+            .with_attr("uid", uid)
+            .with_attr("name", name)
+            .with_attr("namespace", namespace)
+            .with_attr("node", node);
             measurements.push(p_usr);
         }
         if let Some(value_sys) = diff_sys {
@@ -111,10 +120,10 @@ impl alumet::pipeline::Source for K8SProbe {
                 consumer.clone(),
                 value_sys as u64,
             )
-            .with_attr("uid", AttributeValue::String(metrics.uid.clone()))
-            .with_attr("name", AttributeValue::String(metrics.name.clone()))
-            .with_attr("namespace", AttributeValue::String(metrics.namespace.clone()))
-            .with_attr("node", AttributeValue::String(metrics.node.clone()));
+            .with_attr("uid", uid)
+            .with_attr("name", name)
+            .with_attr("namespace", namespace)
+            .with_attr("node", node);
 
             measurements.push(p_sys);
         }
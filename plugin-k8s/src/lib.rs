@@ -94,7 +94,9 @@ impl AlumetPlugin for K8sPlugin {
                 counter_tmp_sys,
                 counter_tmp_usr,
             )?;
-            alumet.add_source(Box::new(probe), TriggerSpec::at_interval(self.config.poll_interval));
+            // the probe reads cgroup files, which is blocking I/O
+            let trigger = TriggerSpec::builder(self.config.poll_interval).blocking_poll().build()?;
+            alumet.add_source(Box::new(probe), trigger);
         }
 
         return Ok(());
@@ -204,16 +206,53 @@ impl AlumetPlugin for K8sPlugin {
                                 )
                                 .with_context(|| format!("Error creating a metric:"))?;
 
-                                // Add the probe to the sources
+                                // Add the probe to the sources.
+                                // Like at startup, reading cgroup files is blocking I/O.
+                                let trigger = TriggerSpec::builder(pod_detect.poll_interval)
+                                    .blocking_poll()
+                                    .build()?;
                                 pod_detect.control_handle.add_source(
                                     pod_detect.plugin_name.clone(),
                                     pod_uid.to_string(),
                                     Box::new(probe),
-                                    TriggerSpec::at_interval(pod_detect.poll_interval),
+                                    trigger,
                                 );
                             }
                         }
                         Ok(())
+                    } else if let Ok(Event {
+                        kind: EventKind::Remove(notify::event::RemoveKind::Folder),
+                        paths,
+                        ..
+                    }) = event
+                    {
+                        // A pod cgroup disappeared: retire the corresponding source so that we
+                        // stop polling a dead file descriptor and release it.
+                        for path in paths {
+                            match path.extension() {
+                                Some(os_str) => match os_str.to_str() {
+                                    Some("slice") => {
+                                        log::debug!(".slice extension found, will continue");
+                                    }
+                                    _ => {
+                                        // Not a pod cgroup, nothing to retire
+                                        return Ok(());
+                                    }
+                                },
+                                None => {
+                                    return Ok(());
+                                }
+                            };
+                            if let Some(pod_uid) = path.file_name() {
+                                let pod_uid = pod_uid.to_str().expect("Can't retrieve the pod uid value");
+                                // The source was added under the name of the cgroup directory,
+                                // remove it under the same name.
+                                pod_detect
+                                    .control_handle
+                                    .remove_source(pod_detect.plugin_name.clone(), pod_uid.to_string());
+                            }
+                        }
+                        Ok(())
                     } else {
                         Ok(())
                     }
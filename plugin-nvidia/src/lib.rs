@@ -97,6 +97,8 @@ impl NvidiaPlugin {
                 let source = nvml::NvmlSource::new(device, metrics.clone())?;
                 let trigger = TriggerSpec::builder(self.config.poll_interval)
                     .flush_interval(self.config.flush_interval)
+                    // NVML calls block in the driver, keep them off the async workers
+                    .blocking_poll()
                     .build()?;
                 alumet.add_source(Box::new(source), trigger);
             }
@@ -124,6 +126,8 @@ impl NvidiaPlugin {
         let source = jetson::JetsonInaSource::open_sensors(sensors, alumet)?;
         let trigger = TriggerSpec::builder(self.config.poll_interval)
             .flush_interval(self.config.flush_interval)
+            // the INA sensors are read through sysfs files, which is blocking I/O
+            .blocking_poll()
             .build()?;
         alumet.add_source(Box::new(source), trigger);
         Ok(())
@@ -15,6 +15,9 @@ use alumet::{
     units::Unit,
 };
 use anyhow::Context;
+use nvml_wrapper::enums::device::SampleValue;
+use nvml_wrapper::structs::device::FieldId;
+use nvml_wrapper::sys_exports::field_id;
 use nvml_wrapper::{error::NvmlError, Device, Nvml};
 use nvml_wrapper_sys::bindings::nvmlDevice_t;
 
@@ -79,9 +82,32 @@ impl alumet::pipeline::Source for NvmlSource {
         // no consumer, we just monitor the device here
         let consumer = ResourceConsumer::LocalMachine;
 
+        // Fetch all the batchable fields in a single nvmlDeviceGetFieldValues call:
+        // each dedicated nvmlDeviceGet* function is a separate driver round trip (~100µs+),
+        // the batched call fetches every supported field in one.
+        let mut batched_energy: Option<u64> = None;
+        if !features.batched_fields.is_empty() {
+            for sample in device.field_values_for(&features.batched_fields)? {
+                let sample = sample?;
+                if sample.field.0 == field_id::NVML_FI_DEV_TOTAL_ENERGY_CONSUMPTION as u32 {
+                    batched_energy = Some(match sample.value? {
+                        SampleValue::U64(v) => v,
+                        SampleValue::U32(v) => v as u64,
+                        SampleValue::I64(v) => v as u64,
+                        SampleValue::F64(v) => v as u64,
+                    });
+                }
+            }
+        }
+
         if features.total_energy_consumption {
+            // the energy reading, from the batched call if the field is supported
+            let raw_energy = match batched_energy {
+                Some(v) => v,
+                None => device.total_energy_consumption()?,
+            };
             // the difference in milliJoules
-            let diff = match self.energy_counter.update(device.total_energy_consumption()?) {
+            let diff = match self.energy_counter.update(raw_energy) {
                 CounterDiffUpdate::FirstTime => None,
                 CounterDiffUpdate::Difference(diff) => Some(diff),
                 CounterDiffUpdate::CorrectedDifference(diff) => Some(diff),
@@ -195,7 +221,7 @@ impl alumet::pipeline::Source for NvmlSource {
             ));
         }
 
-        // TODO explore device.samples() to gather multiple metrics at once
+        // TODO explore device.samples() to gather the history of a metric in one call
         Ok(())
     }
 }
@@ -259,6 +285,11 @@ impl Metrics {
 /// Indicates which features are available on a given NVML device.
 #[derive(Debug)]
 pub struct OptionalFeatures {
+    /// Field ids that can be fetched together with a single `nvmlDeviceGetFieldValues` call.
+    ///
+    /// Only a few metrics have a field id equivalent (see [`detect_batched_fields`]),
+    /// the others keep their dedicated `nvmlDeviceGet*` call.
+    batched_fields: Vec<FieldId>,
     total_energy_consumption: bool,
     instant_power: bool,
     major_utilization: bool,
@@ -280,6 +311,7 @@ impl OptionalFeatures {
     /// Detect the features available on the given device.
     pub fn detect_on(device: &Device) -> Result<Self, NvmlError> {
         Ok(Self {
+            batched_fields: detect_batched_fields(device),
             total_energy_consumption: is_supported(device.total_energy_consumption())?,
             instant_power: is_supported(device.power_usage())?,
             major_utilization: is_supported(device.utilization_rates())?,
@@ -308,6 +340,9 @@ impl OptionalFeatures {
 impl Display for OptionalFeatures {
     fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
         let mut available = Vec::new();
+        if !self.batched_fields.is_empty() {
+            available.push("batched_field_values");
+        }
         if self.total_energy_consumption {
             available.push("total_energy_consumption");
         }
@@ -359,6 +394,31 @@ fn check_running_graphics_processes(device: &Device) -> Result<AvailableVersion,
     }
 }
 
+/// Detects which metrics can be fetched through `nvmlDeviceGetFieldValues`,
+/// which batches several fields into a single driver round trip.
+///
+/// In the NVML version matching our bindings, only the total energy consumption
+/// has a field id equivalent; the utilization rates and process counts do not,
+/// so they must keep their dedicated calls. More candidates can be added here
+/// when the bindings gain the corresponding field ids (e.g. the instant power).
+fn detect_batched_fields(device: &Device) -> Vec<FieldId> {
+    let candidates = vec![FieldId(field_id::NVML_FI_DEV_TOTAL_ENERGY_CONSUMPTION as u32)];
+    match device.field_values_for(&candidates) {
+        Ok(samples) => samples
+            .into_iter()
+            .zip(candidates)
+            .filter_map(|(sample, field)| match sample {
+                Ok(s) if s.value.is_ok() => Some(field),
+                _ => None,
+            })
+            .collect(),
+        Err(e) => {
+            log::debug!("nvmlDeviceGetFieldValues is not usable on this device: {e}");
+            Vec::new()
+        }
+    }
+}
+
 fn is_supported<T>(res: Result<T, NvmlError>) -> Result<bool, NvmlError> {
     match res {
         Ok(_) => Ok(true),
@@ -48,6 +48,10 @@ impl AlumetPlugin for PerfPlugin {
 
     fn init(config: alumet::plugin::ConfigTable) -> anyhow::Result<Box<Self>> {
         let config: Config = deserialize_config(config)?;
+        anyhow::ensure!(
+            config.max_groups_per_source > 0,
+            "max_groups_per_source must be at least 1"
+        );
         let config = ParsedConfig {
             hardware_events: config
                 .hardware_events
@@ -70,6 +74,7 @@ impl AlumetPlugin for PerfPlugin {
             hardware_metrics: Vec::new(),
             software_metrics: Vec::new(),
             cache_metrics: Vec::new(),
+            max_groups_per_source: config.max_groups_per_source,
         };
         Ok(Box::new(PerfPlugin {
             config: Arc::new(Mutex::new(config)),
@@ -152,15 +157,26 @@ impl AlumetPlugin for PerfPlugin {
                             .add(event.event.clone(), *metric)
                             .with_context(|| format!("could not configure cache event {}", event.name))?;
                     }
-                    let source = builder.build()?;
-
-                    // Add the source to Alumet's pipeline.
-                    control_handle.add_source(
-                        plugin_name.clone(),
-                        source_name,
-                        Box::new(source),
-                        TriggerSpec::at_interval(Duration::from_secs(1)), // TODO config
-                    );
+                    // Each group is read with one syscall (PERF_FORMAT_GROUP), but a cgroup
+                    // needs one group per CPU: shard them into several sources so that the
+                    // reads of a big machine don't all serialize in a single source task.
+                    let sources = builder.build_sharded(config.max_groups_per_source)?;
+                    let sharded = sources.len() > 1;
+
+                    // Add the source(s) to Alumet's pipeline.
+                    for (i, source) in sources.into_iter().enumerate() {
+                        let source_name = if sharded {
+                            format!("{source_name}-shard{i}")
+                        } else {
+                            source_name.clone()
+                        };
+                        control_handle.add_source(
+                            plugin_name.clone(),
+                            source_name,
+                            Box::new(source),
+                            TriggerSpec::at_interval(Duration::from_secs(1)), // TODO config
+                        );
+                    }
                     log::debug!("New source has started.");
                 }
             }
@@ -179,6 +195,17 @@ struct Config {
     hardware_events: Vec<String>,
     software_events: Vec<String>,
     cache_events: Vec<String>,
+    /// Maximum number of perf event groups polled by a single source.
+    ///
+    /// A cgroup observable needs one group per CPU, so a big machine can end up
+    /// with hundreds of groups: splitting them into several sources allows the
+    /// pipeline to poll them concurrently.
+    #[serde(default = "default_max_groups_per_source")]
+    max_groups_per_source: usize,
+}
+
+fn default_max_groups_per_source() -> usize {
+    16
 }
 
 impl Default for Config {
@@ -191,6 +218,7 @@ impl Default for Config {
             ],
             software_events: vec![],
             cache_events: vec!["LL_READ_MISS".to_owned()],
+            max_groups_per_source: default_max_groups_per_source(),
         }
     }
 }
@@ -203,4 +231,5 @@ struct ParsedConfig {
     hardware_metrics: Vec<TypedMetricId<u64>>,
     software_metrics: Vec<TypedMetricId<u64>>,
     cache_metrics: Vec<TypedMetricId<u64>>,
+    max_groups_per_source: usize,
 }
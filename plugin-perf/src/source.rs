@@ -203,23 +203,37 @@ impl PerfEventSourceBuilder {
         Ok(self)
     }
 
-    pub fn build(mut self) -> io::Result<PerfEventSource> {
-        log::debug!(
-            "Built PerfEventSource with groups [{}]",
-            self.groups
-                .iter()
-                .map(|g| format!(
-                    "{{resource: {:?}, consumer: {:?}, cpu: {:?}, events: {:?}}}",
-                    g.observed_resource, g.observed_consumer, g.cpu_id, g.counters
-                ))
-                .join(", ")
-        );
+    /// Enables the counters and builds the sources, splitting the event groups into
+    /// multiple sources of at most `max_groups_per_source` groups each.
+    ///
+    /// Each group is read with a single `read` syscall (thanks to `PERF_FORMAT_GROUP`,
+    /// see [`add`](Self::add)), but a cgroup observable still needs one group per CPU.
+    /// On a large machine, polling all of them from a single source task serializes
+    /// hundreds of syscalls; registering the shards as separate sources lets the
+    /// pipeline poll them concurrently, like the per-device sources of other plugins.
+    pub fn build_sharded(mut self, max_groups_per_source: usize) -> io::Result<Vec<PerfEventSource>> {
+        assert!(max_groups_per_source > 0, "max_groups_per_source must be at least 1");
         for group in &mut self.groups {
             group.perf_group.enable()?;
         }
 
-        Ok(PerfEventSource {
-            event_groups: self.groups,
-        })
+        let mut sources = Vec::with_capacity(self.groups.len().div_ceil(max_groups_per_source));
+        let mut groups = self.groups;
+        while !groups.is_empty() {
+            let rest = groups.split_off(groups.len().min(max_groups_per_source));
+            log::debug!(
+                "Built PerfEventSource shard with groups [{}]",
+                groups
+                    .iter()
+                    .map(|g| format!(
+                        "{{resource: {:?}, consumer: {:?}, cpu: {:?}, events: {:?}}}",
+                        g.observed_resource, g.observed_consumer, g.cpu_id, g.counters
+                    ))
+                    .join(", ")
+            );
+            sources.push(PerfEventSource { event_groups: groups });
+            groups = rest;
+        }
+        Ok(sources)
     }
 }
@@ -4,7 +4,7 @@
 use std::{
     fmt::Display,
     fs::{self, File},
-    io::{Read, Seek},
+    os::unix::fs::FileExt,
     path::{Path, PathBuf},
 };
 
@@ -152,12 +152,25 @@ pub fn all_power_zones() -> anyhow::Result<PowerZoneHierarchy> {
     Ok(PowerZoneHierarchy { flat, top })
 }
 
+/// Size of the buffer used to read one `energy_uj` file.
+///
+/// The content of `energy_uj` never exceeds those of `max_energy_range_uj`,
+/// which is 16 bytes (+ newline) on all our test machines: 24 bytes leave some margin
+/// while keeping all the zone buffers in one cache line pair.
+const ZONE_READING_BUF_SIZE: usize = 24;
+
 /// Powercap probe
 pub struct PowercapProbe {
     metric: TypedMetricId<f64>,
 
     /// Ready-to-use powercap zones with additional metadata
     zones: Vec<OpenedZone>,
+
+    /// Preallocated reading buffers, one per zone, reused on every poll.
+    reading_bufs: Vec<[u8; ZONE_READING_BUF_SIZE]>,
+
+    /// Number of bytes read into each reading buffer on the current poll.
+    reading_lens: Vec<usize>,
 }
 
 struct OpenedZone {
@@ -208,7 +221,14 @@ impl PowercapProbe {
             opened.push(opened_zone);
         }
 
-        Ok(PowercapProbe { metric, zones: opened })
+        let reading_bufs = vec![[0u8; ZONE_READING_BUF_SIZE]; opened.len()];
+        let reading_lens = vec![0; opened.len()];
+        Ok(PowercapProbe {
+            metric,
+            zones: opened,
+            reading_bufs,
+            reading_lens,
+        })
     }
 }
 
@@ -218,22 +238,20 @@ impl alumet::pipeline::Source for PowercapProbe {
         measurements: &mut MeasurementAccumulator,
         timestamp: Timestamp,
     ) -> Result<(), alumet::pipeline::PollError> {
-        // Reuse the same buffer for all the zones.
-        // The size of the content of the file `energy_uj` should never exceed those of `max_energy_uj`,
-        // which is 16 bytes on all our test machines (if it does exceed 16 bytes it's fine, but less optimal).
-        let mut zone_reading_buf = Vec::with_capacity(16);
-
-        for zone in &mut self.zones {
-            // read the file from the beginning
-            zone.file
-                .rewind()
-                .with_context(|| format!("failed to rewind {:?}", zone.file))?;
-            zone.file
-                .read_to_end(&mut zone_reading_buf)
+        // Batch phase 1: read all the zone counters back-to-back into the preallocated buffers.
+        // read_at (pread) replaces the rewind+read+read(EOF) sequence: one syscall per zone,
+        // and the reads happen as close to each other as possible, so all the zones are
+        // sampled at (almost) the same moment.
+        for (i, (zone, buf)) in self.zones.iter().zip(&mut self.reading_bufs).enumerate() {
+            self.reading_lens[i] = zone
+                .file
+                .read_at(buf, 0)
                 .with_context(|| format!("failed to read {:?}", zone.file))?;
+        }
 
-            // parse the content of the file
-            let content = std::str::from_utf8(&zone_reading_buf)?;
+        // Batch phase 2: parse the values and update the counters, no syscall involved.
+        for (i, zone) in self.zones.iter_mut().enumerate() {
+            let content = std::str::from_utf8(&self.reading_bufs[i][..self.reading_lens[i]])?;
             let counter_value: u64 = content
                 .trim_end()
                 .parse()
@@ -250,12 +268,9 @@ impl alumet::pipeline::Source for PowercapProbe {
                 let consumer = ResourceConsumer::LocalMachine;
                 measurements.push(
                     MeasurementPoint::new(timestamp, self.metric, zone.resource.clone(), consumer, joules)
-                        .with_attr("domain", AttributeValue::String(zone.domain.to_string())),
+                        .with_attr("domain", AttributeValue::Str(zone.domain.as_str())),
                 )
             };
-
-            // clear the buffer, so that we can fill it again
-            zone_reading_buf.clear();
         }
         Ok(())
     }
@@ -5,21 +5,69 @@ use std::time::{SystemTime, UNIX_EPOCH};
 use crate::protocol::metric_collector_client::MetricCollectorClient;
 use crate::protocol::{self, RegisterReply};
 
-use alumet::measurement::{
-    AttributeValue, MeasurementBuffer, MeasurementPoint, WrappedMeasurementType, WrappedMeasurementValue,
-};
+use alumet::measurement::{AttributeValue, MeasurementBuffer, WrappedMeasurementType, WrappedMeasurementValue};
+use alumet::resources::{Resource, ResourceConsumer};
 use alumet::pipeline::runtime::IdlePipeline;
 use alumet::pipeline::OutputContext;
 use alumet::plugin::rust::{deserialize_config, serialize_config, AlumetPlugin};
 use alumet::plugin::ConfigTable;
-use anyhow::Context;
+use anyhow::{anyhow, Context};
 use serde::{Deserialize, Serialize};
+use tokio::sync::mpsc::{self, error::TrySendError};
+use tokio_stream::wrappers::ReceiverStream;
+use tonic::codec::CompressionEncoding;
 use tonic::transport::Channel;
 
 pub struct RelayClientPlugin {
     client_name: String,
     collector_uri: String,
-    metric_ids: Arc<Mutex<HashMap<u64, u64>>>,
+    send_queue_size: usize,
+    max_overflow_points: usize,
+    metric_ids: Arc<MetricIdMap>,
+}
+
+/// The local→collector metric id mapping.
+///
+/// The mapping is written when `register_metrics` runs (once at startup, rarely after),
+/// but read for every point of every outgoing buffer. It is therefore stored as a
+/// dense vector indexed by the local metric id, behind a swappable snapshot:
+/// the conversion hot path clones the current snapshot (one `Arc` clone) and then
+/// does a plain array index per point, and a registration builds a new vector and
+/// swaps it in, without ever blocking the readers during the conversion.
+struct MetricIdMap {
+    /// The current snapshot. The mutex is held only to clone or replace the `Arc`
+    /// (a pointer copy), never during the conversion of a buffer.
+    snapshot: Mutex<Arc<Vec<u64>>>,
+}
+
+/// Value of the entries of [`MetricIdMap`] that have no collector id (never registered).
+const UNMAPPED_METRIC: u64 = u64::MAX;
+
+impl MetricIdMap {
+    fn new() -> Self {
+        Self {
+            snapshot: Mutex::new(Arc::new(Vec::new())),
+        }
+    }
+
+    /// Returns the current snapshot of the mapping, indexed by local metric id.
+    fn snapshot(&self) -> Arc<Vec<u64>> {
+        self.snapshot.lock().unwrap().clone()
+    }
+
+    /// Adds mappings `(local id, collector id)` and swaps in the new snapshot.
+    fn update(&self, mappings: impl IntoIterator<Item = (u64, u64)>) {
+        let mut current = self.snapshot.lock().unwrap();
+        let mut table: Vec<u64> = (**current).clone();
+        for (local_id, collector_id) in mappings {
+            let idx = local_id as usize;
+            if idx >= table.len() {
+                table.resize(idx + 1, UNMAPPED_METRIC);
+            }
+            table[idx] = collector_id;
+        }
+        *current = Arc::new(table);
+    }
 }
 
 #[derive(Serialize, Deserialize)]
@@ -32,6 +80,19 @@ struct Config {
     /// The URI of the collector, for instance `http://127.0.0.1:50051`.
     #[serde(default = "default_collector_uri")]
     collector_uri: String,
+
+    /// How many flushed buffers can wait in memory for the collector.
+    ///
+    /// When the queue is full (slow or unreachable collector), the output does not block:
+    /// the new measurements are coalesced into a single overflow buffer, which is sent
+    /// when the queue has room again.
+    #[serde(default = "default_send_queue_size")]
+    send_queue_size: usize,
+
+    /// How many measurement points the overflow buffer can hold.
+    /// Beyond that, the oldest points are dropped.
+    #[serde(default = "default_max_overflow_points")]
+    max_overflow_points: usize,
 }
 
 impl Default for Config {
@@ -39,6 +100,8 @@ impl Default for Config {
         Self {
             client_name: default_client_name(),
             collector_uri: default_collector_uri(),
+            send_queue_size: default_send_queue_size(),
+            max_overflow_points: default_max_overflow_points(),
         }
     }
 }
@@ -54,6 +117,14 @@ fn default_collector_uri() -> String {
     String::from("http://[::1]:50051")
 }
 
+fn default_send_queue_size() -> usize {
+    128
+}
+
+fn default_max_overflow_points() -> usize {
+    100_000
+}
+
 impl AlumetPlugin for RelayClientPlugin {
     fn name() -> &'static str {
         "plugin-relay:client"
@@ -71,43 +142,59 @@ impl AlumetPlugin for RelayClientPlugin {
         // Read the configuration.
         let config = deserialize_config::<Config>(config)?;
 
-        // Initialize a thread-safe HashMap to store the mapping 'local metric id' -> 'collector metric id'
-        let metric_ids = Arc::new(Mutex::new(HashMap::new()));
+        // Initialize the shared mapping 'local metric id' -> 'collector metric id'
+        let metric_ids = Arc::new(MetricIdMap::new());
 
         // Return initialized plugin.
         Ok(Box::new(Self {
             client_name: config.client_name,
             collector_uri: config.collector_uri,
+            send_queue_size: config.send_queue_size,
+            max_overflow_points: config.max_overflow_points,
             metric_ids,
         }))
     }
 
     fn start(&mut self, alumet: &mut alumet::plugin::AlumetStart) -> anyhow::Result<()> {
         let collector_uri = self.collector_uri.clone();
-        let client_name = self.client_name.clone();
         let metric_ids = self.metric_ids.clone();
+        let send_queue_size = self.send_queue_size;
+        let max_overflow_points = self.max_overflow_points;
 
         // The output cannot be created right now: we need the tokio Runtime (see below).
         alumet.add_output_builder(move |pipeline| {
             log::info!("Connecting to gRPC server {collector_uri}...");
 
             // Connect to gRPC server, using the tokio runtime in which Alumet will trigger the output.
-            // We also store the runtime handle, for use in `pre_pipeline_start`.
             // This is important because a Tonic gRPC client can only be used from the runtime that it has been initialized with.
             let rt = pipeline.async_runtime_handle();
 
-            let grpc_client = rt
+            let mut grpc_client = rt
                 .block_on(MetricCollectorClient::connect(collector_uri))
-                .context("Failed to connect to gRPC server")?;
-
-            let client = RelayClient {
-                grpc_client,
-                client_name,
-                metric_ids,
-            };
+                .context("Failed to connect to gRPC server")?
+                .send_compressed(CompressionEncoding::Gzip)
+                .accept_compressed(CompressionEncoding::Gzip);
             log::info!("Connected successfully.");
 
-            Ok(Box::new(RelayOutput { client }))
+            // Open one long-lived client-streaming RPC, fed by a bounded queue.
+            // The connection and its flow control are established only once,
+            // and a slow collector backpressures the queue instead of the whole pipeline.
+            let (send_queue, rx) = mpsc::channel::<protocol::MeasurementChunk>(send_queue_size);
+            rt.spawn(async move {
+                let outbound = ReceiverStream::new(rx);
+                match grpc_client.stream_measurements(tonic::Request::new(outbound)).await {
+                    Ok(response) => log::debug!("Measurement stream closed normally: {response:?}"),
+                    Err(status) => log::error!("Measurement stream to the collector failed: {status}"),
+                }
+            });
+
+            Ok(Box::new(RelayOutput {
+                metric_ids,
+                send_queue,
+                overflow: protocol::MeasurementChunk::default(),
+                max_overflow_points,
+                dropped_points: 0,
+            }))
         });
         Ok(())
     }
@@ -141,110 +228,222 @@ impl AlumetPlugin for RelayClientPlugin {
 }
 
 struct RelayOutput {
-    client: RelayClient,
-}
+    metric_ids: Arc<MetricIdMap>,
 
-impl alumet::pipeline::Output for RelayOutput {
-    fn write(
-        &mut self,
-        measurements: &MeasurementBuffer,
-        _ctx: &OutputContext,
-    ) -> Result<(), alumet::pipeline::WriteError> {
-        // Acquire the client.
-        let client = &mut self.client;
-        // Get a handle to the current tokio runtime. This works because Alumet outputs are executed inside of a tokio runtime.
-        let handle = tokio::runtime::Handle::current();
-        // Execute send_measurements in a blocking way (wait for it to finish).
-        handle
-            .block_on(client.send_measurements(measurements))
-            .context("error in send_measurements")?;
-        Ok(())
-    }
-}
+    /// Bounded queue to the task that owns the measurement stream.
+    send_queue: mpsc::Sender<protocol::MeasurementChunk>,
 
-struct RelayClient {
-    grpc_client: MetricCollectorClient<Channel>,
-    metric_ids: Arc<Mutex<HashMap<u64, u64>>>,
-    client_name: String,
+    /// Points that could not be enqueued because the queue was full,
+    /// coalesced into a single chunk (oldest first).
+    overflow: protocol::MeasurementChunk,
+
+    /// Maximum number of points in `overflow`, beyond which the oldest points are dropped.
+    max_overflow_points: usize,
+
+    /// Total number of points dropped so far, for diagnostics.
+    dropped_points: u64,
 }
 
-impl RelayClient {
-    async fn send_measurements(&mut self, measurements: &MeasurementBuffer) -> anyhow::Result<()> {
-        fn convert_alumet_to_protobuf(
-            m: &MeasurementPoint,
-            metric_ids: &mut HashMap<u64, u64>,
-        ) -> protocol::MeasurementPoint {
-            // convert metric id
-            let metric = *metric_ids.get(&m.metric.as_u64()).unwrap();
-
-            // TODO: if the connection drops, the client will retry to connect, which is good.
-            // But if the server has crashed, its MetricRegistry has been reinitialized,
-            // and the metrics of the client should be registered again (otherwise the server will error on metric ingestion).
-
-            // convert timestamp
-            let time_diff = SystemTime::from(m.timestamp)
-                .duration_since(UNIX_EPOCH)
-                .expect("Every timestamp should be obtained from system_time_now()");
-
-            // convert value
-            let value = match m.value {
-                WrappedMeasurementValue::F64(x) => protocol::measurement_point::Value::F64(x),
-                WrappedMeasurementValue::U64(x) => protocol::measurement_point::Value::U64(x),
-            };
+/// Encodes a whole buffer as one columnar chunk.
+///
+/// The resources, consumers and attribute keys are deduplicated into per-chunk
+/// dictionaries, so that the repeated values (and there are many: a typical buffer
+/// contains a handful of metrics and resources for hundreds of points) are encoded once.
+fn convert_buffer_to_chunk(
+    measurements: &MeasurementBuffer,
+    metric_ids: &[u64],
+) -> protocol::MeasurementChunk {
+    // TODO: if the connection drops, the client will retry to connect, which is good.
+    // But if the server has crashed, its MetricRegistry has been reinitialized,
+    // and the metrics of the client should be registered again (otherwise the server will error on metric ingestion).
+
+    let n = measurements.len();
+    let mut chunk = protocol::MeasurementChunk {
+        metrics: Vec::with_capacity(n),
+        timestamps_secs: Vec::with_capacity(n),
+        timestamps_nanos: Vec::with_capacity(n),
+        resource_indexes: Vec::with_capacity(n),
+        consumer_indexes: Vec::with_capacity(n),
+        value_is_f64: Vec::with_capacity(n),
+        attribute_counts: Vec::with_capacity(n),
+        ..Default::default()
+    };
+    let mut resource_dict: HashMap<Resource, u32> = HashMap::new();
+    let mut consumer_dict: HashMap<ResourceConsumer, u32> = HashMap::new();
+    let mut key_dict: HashMap<String, u32> = HashMap::new();
+
+    for m in measurements.iter() {
+        // convert metric id (a plain array index, see MetricIdMap)
+        let collector_id = metric_ids[m.metric.as_u64() as usize];
+        assert_ne!(
+            collector_id,
+            UNMAPPED_METRIC,
+            "metric {} has not been registered with the collector",
+            m.metric.as_u64()
+        );
+        chunk.metrics.push(collector_id);
+
+        // convert timestamp
+        let time_diff = SystemTime::from(m.timestamp)
+            .duration_since(UNIX_EPOCH)
+            .expect("Every timestamp should be obtained from system_time_now()");
+        chunk.timestamps_secs.push(time_diff.as_secs());
+        chunk.timestamps_nanos.push(time_diff.subsec_nanos());
+
+        // convert value
+        match m.value {
+            WrappedMeasurementValue::F64(x) => {
+                chunk.value_is_f64.push(true);
+                chunk.f64_values.push(x);
+            }
+            WrappedMeasurementValue::U64(x) => {
+                chunk.value_is_f64.push(false);
+                chunk.u64_values.push(x);
+            }
+        };
 
-            // convert resource and consumer
-            let resource = protocol::Resource {
+        // convert resource and consumer, deduplicated through the dictionaries
+        let resource_idx = *resource_dict.entry(m.resource.clone()).or_insert_with(|| {
+            chunk.resources.push(protocol::Resource {
                 kind: m.resource.kind().to_owned(),
                 id: m.resource.id_string(),
-            };
-            let consumer = protocol::ResourceConsumer {
+            });
+            (chunk.resources.len() - 1) as u32
+        });
+        chunk.resource_indexes.push(resource_idx);
+        let consumer_idx = *consumer_dict.entry(m.consumer.clone()).or_insert_with(|| {
+            chunk.consumers.push(protocol::ResourceConsumer {
                 kind: m.consumer.kind().to_owned(),
                 id: m.consumer.id_string(),
+            });
+            (chunk.consumers.len() - 1) as u32
+        });
+        chunk.consumer_indexes.push(consumer_idx);
+
+        // convert attributes, flattened after the previous points' attributes
+        let mut attr_count = 0u32;
+        for (attr_key, attr_value) in m.attributes() {
+            let key_idx = match key_dict.get(attr_key) {
+                Some(idx) => *idx,
+                None => {
+                    let idx = chunk.attribute_keys.len() as u32;
+                    chunk.attribute_keys.push(attr_key.to_owned());
+                    key_dict.insert(attr_key.to_owned(), idx);
+                    idx
+                }
             };
-
-            // convert attributes
-            let attributes = m
-                .attributes()
-                .map(|(attr_key, attr_value)| protocol::MeasurementAttribute {
-                    key: attr_key.to_owned(),
-                    value: Some(match attr_value {
-                        AttributeValue::F64(v) => protocol::measurement_attribute::Value::F64(*v),
-                        AttributeValue::U64(v) => protocol::measurement_attribute::Value::U64(*v),
-                        AttributeValue::Bool(v) => protocol::measurement_attribute::Value::Bool(*v),
-                        AttributeValue::String(v) => protocol::measurement_attribute::Value::Str(v.to_owned()),
-                        AttributeValue::Str(v) => protocol::measurement_attribute::Value::Str(v.to_string()),
-                    }),
-                })
-                .collect();
-
-            // create point
-            protocol::MeasurementPoint {
-                metric,
-                timestamp_secs: time_diff.as_secs(),
-                timestamp_nanos: time_diff.subsec_nanos(),
-                value: Some(value),
-                resource: Some(resource),
-                consumer: Some(consumer),
-                attributes,
-            }
+            chunk.attribute_key_indexes.push(key_idx);
+            chunk.attribute_values.push(protocol::AttributeValue {
+                value: Some(match attr_value {
+                    AttributeValue::F64(v) => protocol::attribute_value::Value::F64(*v),
+                    AttributeValue::U64(v) => protocol::attribute_value::Value::U64(*v),
+                    AttributeValue::Bool(v) => protocol::attribute_value::Value::Bool(*v),
+                    AttributeValue::String(v) => protocol::attribute_value::Value::Str(v.to_owned()),
+                    AttributeValue::Str(v) => protocol::attribute_value::Value::Str(v.to_string()),
+                }),
+            });
+            attr_count += 1;
         }
+        chunk.attribute_counts.push(attr_count);
+    }
+    chunk
+}
 
-        let mut metric_ids = self.metric_ids.lock().unwrap();
-        let points: Vec<protocol::MeasurementPoint> = measurements
-            .iter()
-            .map(|point| convert_alumet_to_protobuf(point, &mut metric_ids))
-            .collect();
+/// Appends the points of `src` after those of `dst`.
+///
+/// The dictionaries are simply concatenated (the indexes of `src` are shifted),
+/// without re-deduplicating across the two chunks: this stays O(points).
+fn append_chunk(dst: &mut protocol::MeasurementChunk, src: protocol::MeasurementChunk) {
+    let resource_offset = dst.resources.len() as u32;
+    let consumer_offset = dst.consumers.len() as u32;
+    let key_offset = dst.attribute_keys.len() as u32;
+    dst.resources.extend(src.resources);
+    dst.consumers.extend(src.consumers);
+    dst.attribute_keys.extend(src.attribute_keys);
+    dst.metrics.extend(src.metrics);
+    dst.timestamps_secs.extend(src.timestamps_secs);
+    dst.timestamps_nanos.extend(src.timestamps_nanos);
+    dst.resource_indexes
+        .extend(src.resource_indexes.into_iter().map(|i| i + resource_offset));
+    dst.consumer_indexes
+        .extend(src.consumer_indexes.into_iter().map(|i| i + consumer_offset));
+    dst.value_is_f64.extend(src.value_is_f64);
+    dst.f64_values.extend(src.f64_values);
+    dst.u64_values.extend(src.u64_values);
+    dst.attribute_counts.extend(src.attribute_counts);
+    dst.attribute_key_indexes
+        .extend(src.attribute_key_indexes.into_iter().map(|i| i + key_offset));
+    dst.attribute_values.extend(src.attribute_values);
+}
 
-        log::debug!("Sending gRPC request with {} measurement points", points.len());
-        let request = tonic::Request::new(protocol::MeasurementBuffer { points });
-        let response = self.grpc_client.ingest_measurements(request).await?;
+/// Removes the `count` oldest points of the chunk.
+/// The dictionaries are left untouched, possibly keeping some unreferenced entries.
+fn drop_oldest_points(chunk: &mut protocol::MeasurementChunk, count: usize) {
+    let attr_drop: usize = chunk.attribute_counts[..count].iter().map(|c| *c as usize).sum();
+    let f64_drop = chunk.value_is_f64[..count].iter().filter(|is_f64| **is_f64).count();
+    let u64_drop = count - f64_drop;
+    chunk.metrics.drain(..count);
+    chunk.timestamps_secs.drain(..count);
+    chunk.timestamps_nanos.drain(..count);
+    chunk.resource_indexes.drain(..count);
+    chunk.consumer_indexes.drain(..count);
+    chunk.value_is_f64.drain(..count);
+    chunk.f64_values.drain(..f64_drop);
+    chunk.u64_values.drain(..u64_drop);
+    chunk.attribute_counts.drain(..count);
+    chunk.attribute_key_indexes.drain(..attr_drop);
+    chunk.attribute_values.drain(..attr_drop);
+}
 
-        log::trace!("RESPONSE={:?}", response);
-        // TODO handle the response
+impl alumet::pipeline::Output for RelayOutput {
+    fn write(
+        &mut self,
+        measurements: &MeasurementBuffer,
+        _ctx: &OutputContext,
+    ) -> Result<(), alumet::pipeline::WriteError> {
+        // Encode the buffer as a columnar chunk, using the current snapshot of the metric mapping.
+        let metric_ids = self.metric_ids.snapshot();
+        let mut chunk = convert_buffer_to_chunk(measurements, &metric_ids);
+
+        // Coalesce with the points that overflowed earlier (they are older, keep them first).
+        if !self.overflow.metrics.is_empty() {
+            let mut merged = std::mem::take(&mut self.overflow);
+            append_chunk(&mut merged, chunk);
+            chunk = merged;
+        }
 
-        Ok(())
+        log::debug!("Enqueuing a chunk of {} measurement points for the collector", chunk.metrics.len());
+        match self.send_queue.try_send(chunk) {
+            Ok(()) => Ok(()),
+            Err(TrySendError::Full(chunk)) => {
+                // The collector is slow or unreachable: keep the points in memory
+                // instead of blocking the output task, and cap the memory use.
+                self.overflow = chunk;
+                let excess = self.overflow.metrics.len().saturating_sub(self.max_overflow_points);
+                if excess > 0 {
+                    drop_oldest_points(&mut self.overflow, excess);
+                    self.dropped_points += excess as u64;
+                    log::warn!(
+                        "Send queue to the collector is full: dropped the {excess} oldest points ({} in total since startup).",
+                        self.dropped_points
+                    );
+                }
+                Ok(())
+            }
+            Err(TrySendError::Closed(_)) => Err(alumet::pipeline::WriteError::Fatal(anyhow!(
+                "the measurement stream to the collector is closed"
+            ))),
+        }
     }
+}
 
+struct RelayClient {
+    grpc_client: MetricCollectorClient<Channel>,
+    metric_ids: Arc<MetricIdMap>,
+    client_name: String,
+}
+
+impl RelayClient {
     async fn register_metrics(&mut self, pipeline: &IdlePipeline) -> anyhow::Result<()> {
         let definitions: Vec<protocol::metric_definitions::MetricDef> = pipeline
             .metric_iter()
@@ -276,10 +475,12 @@ impl RelayClient {
         log::debug!("RESPONSE={:?}", response);
 
         let reply: RegisterReply = response.into_inner();
-        let mut metric_ids = self.metric_ids.lock().unwrap();
-        for mapping in reply.mappings {
-            metric_ids.insert(mapping.id_for_agent, mapping.id_for_collector);
-        }
+        self.metric_ids.update(
+            reply
+                .mappings
+                .into_iter()
+                .map(|mapping| (mapping.id_for_agent, mapping.id_for_collector)),
+        );
         Ok(())
     }
 }
@@ -1,4 +1,5 @@
 use std::{
+    hash::{Hash, Hasher},
     net::{IpAddr, SocketAddr, SocketAddrV4, SocketAddrV6, ToSocketAddrs},
     time::{Duration, UNIX_EPOCH},
 };
@@ -18,7 +19,7 @@ use alumet::{
 };
 use anyhow::{anyhow, Context};
 use serde::{Deserialize, Serialize};
-use tonic::{transport::Server, Response, Status};
+use tonic::{codec::CompressionEncoding, transport::Server, Response, Status};
 
 use crate::protocol::{
     self,
@@ -44,6 +45,15 @@ struct Config {
 
     /// IPv6 scope id, for link-local addressing.
     ipv6_scope_id: Option<u32>,
+
+    /// Number of parallel decode workers ("shards").
+    ///
+    /// Each client is assigned to a shard based on its name, and all the measurements
+    /// of the client are decoded by that shard, so a single collector scales with the
+    /// number of cores while the measurements of each client stay in order.
+    /// `0` means one shard per available core.
+    #[serde(default)]
+    ingest_shards: usize,
 }
 
 impl Default for Config {
@@ -52,6 +62,7 @@ impl Default for Config {
             address: String::from("::1"), // Default to localhost on ipv6
             port: 50051,
             ipv6_scope_id: None,
+            ingest_shards: 0,
         }
     }
 }
@@ -103,13 +114,46 @@ impl AlumetPlugin for RelayServerPlugin {
             )),
         };
 
+        // Resolve the number of ingestion shards.
+        let shard_count = match self.config.ingest_shards {
+            0 => std::thread::available_parallelism().map(|n| n.get()).unwrap_or(1),
+            n => n,
+        };
+
         log::info!("Starting gRPC server with on socket {addr}");
         alumet.add_autonomous_source(move |p, cancel_token, out_tx| {
             let late_reg = tokio::sync::Mutex::new(p.late_registration_handle());
-            let collector = GrpcMetricCollector { out_tx, late_reg };
+
+            // One decode worker per shard, each with its own bounded channel.
+            // The gRPC handlers only route the (already deserialized) protobuf messages:
+            // the conversion to Alumet points runs on the shards, in parallel.
+            let mut shard_txs = Vec::with_capacity(shard_count);
+            let mut shard_rxs = Vec::with_capacity(shard_count);
+            for _ in 0..shard_count {
+                let (tx, rx) = tokio::sync::mpsc::channel::<DecodeJob>(SHARD_CHANNEL_CAPACITY);
+                shard_txs.push(tx);
+                shard_rxs.push(rx);
+            }
+            let collector = GrpcMetricCollector {
+                shards: shard_txs,
+                late_reg,
+            };
             async move {
+                log::debug!("Starting {shard_count} ingestion shard(s).");
+                for (shard_id, rx) in shard_rxs.into_iter().enumerate() {
+                    tokio::spawn(run_decode_shard(shard_id, rx, out_tx.clone()));
+                }
+                // The shards hold their own clones of the pipeline channel.
+                drop(out_tx);
+
                 Server::builder()
-                    .add_service(MetricCollectorServer::new(collector))
+                    .add_service(
+                        MetricCollectorServer::new(collector)
+                            // Energy timeseries compress very well, accept compressed streams
+                            // (the compression is negotiated, uncompressed clients still work).
+                            .accept_compressed(CompressionEncoding::Gzip)
+                            .send_compressed(CompressionEncoding::Gzip),
+                    )
                     .serve_with_shutdown(addr, cancel_token.cancelled_owned())
                     .await
                     .context("server error")?;
@@ -124,57 +168,180 @@ impl AlumetPlugin for RelayServerPlugin {
     }
 }
 
+/// How many decoded-but-not-converted messages a shard can hold.
+///
+/// When a shard lags behind, the bounded channel backpressures its clients
+/// (via HTTP/2 flow control), like the pipeline channel did before sharding.
+const SHARD_CHANNEL_CAPACITY: usize = 8;
+
 pub struct GrpcMetricCollector {
-    out_tx: tokio::sync::mpsc::Sender<MeasurementBuffer>,
+    /// The ingestion shards, indexed by `shard_for(client_name)`.
+    shards: Vec<tokio::sync::mpsc::Sender<DecodeJob>>,
     late_reg: tokio::sync::Mutex<LateRegistrationHandle>,
 }
 
+/// A protobuf message waiting to be converted by an ingestion shard.
+enum DecodeJob {
+    Buffer(crate::protocol::MeasurementBuffer),
+    Chunk(crate::protocol::MeasurementChunk),
+}
+
+/// Converts the protobuf messages routed to one shard and feeds the pipeline.
+///
+/// Runs until the shard's channel closes (server shutdown) or the pipeline stops.
+async fn run_decode_shard(
+    shard_id: usize,
+    mut rx: tokio::sync::mpsc::Receiver<DecodeJob>,
+    out_tx: tokio::sync::mpsc::Sender<MeasurementBuffer>,
+) {
+    while let Some(job) = rx.recv().await {
+        let measurements = match job {
+            DecodeJob::Buffer(buf) => convert_protobuf_to_alumet(buf),
+            DecodeJob::Chunk(chunk) => convert_chunk_to_alumet(chunk),
+        };
+        if out_tx.send(measurements).await.is_err() {
+            log::warn!("Ingestion shard {shard_id} stops: the measurement pipeline is shutting down.");
+            break;
+        }
+    }
+}
+
+/// Extracts the name of the client from the request metadata, falling back on its address.
+fn client_name<T>(request: &tonic::Request<T>) -> String {
+    request
+        .metadata()
+        .get("x-alumet-client")
+        .and_then(|v| v.to_str().ok().map(|s| s.to_owned()))
+        .or_else(|| request.remote_addr().map(|addr| addr.to_string()))
+        .unwrap_or_else(|| String::from("?"))
+}
+
+impl GrpcMetricCollector {
+    /// Returns the ingestion shard assigned to this client.
+    ///
+    /// The assignment is a simple hash of the client's name: all the measurements
+    /// of a given client go through the same shard, which keeps them in order.
+    fn shard_for(&self, client_name: &str) -> &tokio::sync::mpsc::Sender<DecodeJob> {
+        let mut hasher = std::collections::hash_map::DefaultHasher::new();
+        client_name.hash(&mut hasher);
+        &self.shards[(hasher.finish() % self.shards.len() as u64) as usize]
+    }
+}
+
+/// Transforms gRPC structures into ALUMET data points.
+fn convert_protobuf_to_alumet(buf: crate::protocol::MeasurementBuffer) -> MeasurementBuffer {
+    // TODO proper error handling
+    let measurements: Vec<MeasurementPoint> = buf
+        .points
+        .into_iter()
+        .map(|m| {
+            let timestamp = Timestamp::from(UNIX_EPOCH + Duration::new(m.timestamp_secs, m.timestamp_nanos));
+            let value = m.value.unwrap().into();
+            let resource = Resource::try_from(m.resource.unwrap()).unwrap();
+            let consumer = ResourceConsumer::try_from(m.consumer.unwrap()).unwrap();
+            let attributes: Vec<_> = m
+                .attributes
+                .into_iter()
+                .map(|attr| (attr.key, attr.value.unwrap().into()))
+                .collect();
+            MeasurementPoint::new_untyped(timestamp, RawMetricId::from_u64(m.metric), resource, consumer, value)
+                .with_attr_vec(attributes)
+        })
+        .collect();
+    MeasurementBuffer::from(measurements)
+}
+
+/// Decodes a columnar chunk straight into a [`MeasurementBuffer`].
+///
+/// The dictionaries are decoded once, then each point only clones the decoded
+/// values it references, instead of parsing one message per point.
+fn convert_chunk_to_alumet(chunk: crate::protocol::MeasurementChunk) -> MeasurementBuffer {
+    // TODO proper error handling
+    let resources: Vec<Resource> = chunk
+        .resources
+        .into_iter()
+        .map(|r| Resource::try_from(r).unwrap())
+        .collect();
+    let consumers: Vec<ResourceConsumer> = chunk
+        .consumers
+        .into_iter()
+        .map(|c| ResourceConsumer::try_from(c).unwrap())
+        .collect();
+    let attribute_keys: Vec<String> = chunk.attribute_keys;
+
+    let n = chunk.metrics.len();
+    let mut buffer = MeasurementBuffer::with_capacity(n);
+    let mut f64_values = chunk.f64_values.into_iter();
+    let mut u64_values = chunk.u64_values.into_iter();
+    let mut attr_key_indexes = chunk.attribute_key_indexes.into_iter();
+    let mut attr_values = chunk.attribute_values.into_iter();
+    for i in 0..n {
+        let timestamp = Timestamp::from(UNIX_EPOCH + Duration::new(chunk.timestamps_secs[i], chunk.timestamps_nanos[i]));
+        let value = if chunk.value_is_f64[i] {
+            WrappedMeasurementValue::F64(f64_values.next().unwrap())
+        } else {
+            WrappedMeasurementValue::U64(u64_values.next().unwrap())
+        };
+        let resource = resources[chunk.resource_indexes[i] as usize].clone();
+        let consumer = consumers[chunk.consumer_indexes[i] as usize].clone();
+        let mut point =
+            MeasurementPoint::new_untyped(timestamp, RawMetricId::from_u64(chunk.metrics[i]), resource, consumer, value);
+        let attr_count = chunk.attribute_counts[i] as usize;
+        if attr_count > 0 {
+            let attributes: Vec<(String, AttributeValue)> = (0..attr_count)
+                .map(|_| {
+                    let key = attribute_keys[attr_key_indexes.next().unwrap() as usize].clone();
+                    let value = attr_values.next().unwrap().value.unwrap().into();
+                    (key, value)
+                })
+                .collect();
+            point = point.with_attr_vec(attributes);
+        }
+        buffer.push(point);
+    }
+    buffer
+}
+
 #[tonic::async_trait]
 impl MetricCollector for GrpcMetricCollector {
     async fn ingest_measurements(
         &self,
         request: tonic::Request<crate::protocol::MeasurementBuffer>,
     ) -> Result<Response<Empty>, Status> {
-        // TODO proper error handling
-
-        // Transform gRPC structures into ALUMET data points.
-        let measurements: Vec<MeasurementPoint> = request
-            .into_inner()
-            .points
-            .into_iter()
-            .map(|m| {
-                let timestamp = Timestamp::from(UNIX_EPOCH + Duration::new(m.timestamp_secs, m.timestamp_nanos));
-                let value = m.value.unwrap().into();
-                let resource = Resource::try_from(m.resource.unwrap()).unwrap();
-                let consumer = ResourceConsumer::try_from(m.consumer.unwrap()).unwrap();
-                let attributes: Vec<_> = m
-                    .attributes
-                    .into_iter()
-                    .map(|attr| (attr.key, attr.value.unwrap().into()))
-                    .collect();
-                MeasurementPoint::new_untyped(timestamp, RawMetricId::from_u64(m.metric), resource, consumer, value)
-                    .with_attr_vec(attributes)
-            })
-            .collect();
-
-        // Send the measurements to the rest of the pipeline.
-        self.out_tx.send(MeasurementBuffer::from(measurements)).await.unwrap();
+        // Route the message to the client's shard, which converts it and feeds the pipeline.
+        let shard = self.shard_for(&client_name(&request));
+        if shard.send(DecodeJob::Buffer(request.into_inner())).await.is_err() {
+            return Err(Status::unavailable("the measurement pipeline is shutting down"));
+        }
 
         // Done.
         Ok(Response::new(Empty {}))
     }
 
+    async fn stream_measurements(
+        &self,
+        request: tonic::Request<tonic::Streaming<crate::protocol::MeasurementChunk>>,
+    ) -> Result<Response<Empty>, Status> {
+        // The client's shard is picked once per stream.
+        let shard = self.shard_for(&client_name(&request)).clone();
+        let mut stream = request.into_inner();
+        // Forward each chunk of the long-lived stream to the client's shard.
+        // The bounded shard channel backpressures the stream (via HTTP/2 flow control)
+        // when the conversion or the collector's outputs cannot keep up.
+        while let Some(chunk) = stream.message().await? {
+            if shard.send(DecodeJob::Chunk(chunk)).await.is_err() {
+                return Err(Status::unavailable("the measurement pipeline is shutting down"));
+            }
+        }
+        Ok(Response::new(Empty {}))
+    }
+
     async fn register_metrics(
         &self,
         request: tonic::Request<crate::protocol::MetricDefinitions>,
     ) -> Result<Response<RegisterReply>, Status> {
         // TODO convert errors to a proper Status
-        let client_name = request
-            .metadata()
-            .get("x-alumet-client")
-            .and_then(|v| v.to_str().ok().map(|s| s.to_owned()))
-            .or_else(|| request.remote_addr().map(|addr| addr.to_string()))
-            .unwrap_or_else(|| String::from("?"));
+        let client_name = client_name(&request);
 
         let (client_metric_ids, metrics): (Vec<u64>, Vec<Metric>) = request
             .into_inner()
@@ -244,6 +411,17 @@ impl From<protocol::measurement_point::Value> for WrappedMeasurementValue {
     }
 }
 
+impl From<protocol::attribute_value::Value> for AttributeValue {
+    fn from(value: protocol::attribute_value::Value) -> Self {
+        match value {
+            protocol::attribute_value::Value::Str(v) => AttributeValue::String(v),
+            protocol::attribute_value::Value::U64(v) => AttributeValue::U64(v),
+            protocol::attribute_value::Value::F64(v) => AttributeValue::F64(v),
+            protocol::attribute_value::Value::Bool(v) => AttributeValue::Bool(v),
+        }
+    }
+}
+
 impl From<protocol::measurement_attribute::Value> for AttributeValue {
     fn from(value: protocol::measurement_attribute::Value) -> Self {
         match value {
@@ -54,12 +54,13 @@ fn run_with_plugin(
     assert_eq!(plugin.version(), expected_plugin_version);
 
     // Start the plugin
-    let mut pipeline_builder = PipelineBuilder::new();
-    let mut handle = AlumetStart::new(&mut pipeline_builder, plugin.name().to_owned());
+    let pipeline_builder = std::sync::Mutex::new(PipelineBuilder::new());
+    let mut handle = AlumetStart::new(&pipeline_builder, plugin.name().to_owned());
     plugin.start(&mut handle).expect("plugin should start fine");
 
     // start the pipeline and wait for the tasks to finish
     println!("[app] Starting the pipeline...");
+    let pipeline_builder = pipeline_builder.into_inner().unwrap();
     let pipeline = pipeline_builder.build().expect("pipeline should build").start();
 
     println!("[app] pipeline started");